@@ -0,0 +1,294 @@
+#include "batch/parameter_sweep.hpp"
+
+#include "batch/work_stealing_pool.hpp"
+#include "stats/stat_factory.hpp"
+#include "stats/stats_collector.hpp"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+QString SweepAxis::getName() const
+{
+    switch (parameter)
+    {
+        case SweepParameter::ArrivalParam1:
+            return QString("arrival param1");
+
+        case SweepParameter::ProcessorCount:
+            return QString("processors %1").arg(stationId);
+
+        case SweepParameter::QueueLength:
+            return QString("queue length %1").arg(stationId);
+
+        case SweepParameter::ConnectionWeight:
+            return QString("weight %1-%2").arg(stationId).arg(targetStationId);
+    }
+
+    return QString();
+}
+
+////////////////////////////////////////////////
+
+ParameterSweep::ParameterSweep(const SimulationInstance& instance)
+ : m_instance(instance)
+ , m_replicationCount(1)
+ , m_threadCount(0)
+ , m_randomSeed(0)
+ , m_resultWriter(nullptr)
+{}
+
+void ParameterSweep::addAxis(const SweepAxis& axis)
+{
+    m_axes.append(axis);
+}
+
+void ParameterSweep::setReplicationCount(int count)
+{
+    m_replicationCount = std::max(count, 1);
+}
+
+void ParameterSweep::setThreadCount(int count)
+{
+    m_threadCount = std::max(count, 0);
+}
+
+void ParameterSweep::setRandomSeed(quint64 seed)
+{
+    m_randomSeed = seed;
+}
+
+void ParameterSweep::setStopCondition(const StopCondition& condition)
+{
+    m_stopCondition = condition;
+}
+
+void ParameterSweep::setSimulationSetup(const SimulationSetup& setup)
+{
+    m_simulationSetup = setup;
+}
+
+void ParameterSweep::addStat(StatType type, int stationId)
+{
+    m_stats.append(qMakePair(type, stationId));
+}
+
+void ParameterSweep::setResultWriter(SweepResultWriter* writer)
+{
+    m_resultWriter = writer;
+}
+
+int ParameterSweep::getPointCount() const
+{
+    int pointCount = 1;
+    for (const SweepAxis& axis : m_axes)
+    {
+        pointCount *= axis.values.size();
+    }
+    return pointCount;
+}
+
+// The last axis changes fastest
+QVector<double> ParameterSweep::getPointValues(int pointIndex) const
+{
+    QVector<double> values(m_axes.size());
+    for (int i = m_axes.size() - 1; i >= 0; --i)
+    {
+        const QVector<double>& axisValues = m_axes.at(i).values;
+        values[i] = axisValues.at(pointIndex % axisValues.size());
+        pointIndex /= axisValues.size();
+    }
+    return values;
+}
+
+bool ParameterSweep::check() const
+{
+    Simulation simulation;
+    simulation.setInstance(m_instance);
+
+    for (const SweepAxis& axis : m_axes)
+    {
+        if (axis.values.isEmpty())
+        {
+            return false;
+        }
+
+        if (axis.parameter == SweepParameter::ConnectionWeight
+            && !simulation.connectionExists(axis.stationId, axis.targetStationId))
+        {
+            return false;
+        }
+
+        if ((axis.parameter == SweepParameter::ProcessorCount || axis.parameter == SweepParameter::QueueLength)
+            && (simulation.getStation(axis.stationId).id != axis.stationId || axis.stationId == INPUT_STATION_ID
+                || axis.stationId == OUTPUT_STATION_ID))
+        {
+            return false;
+        }
+    }
+
+    for (int point = 0; point < getPointCount(); ++point)
+    {
+        applyPoint(simulation, getPointValues(point));
+        if (!simulation.check())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ParameterSweep::run()
+{
+    int pointCount = getPointCount();
+    int statCount = m_stats.size();
+    int jobCount = pointCount * m_replicationCount;
+
+    m_values.fill(0.0, jobCount * statCount);
+    m_summaries.fill(WelfordAccumulator(), pointCount * statCount);
+
+    if (m_resultWriter != nullptr)
+    {
+        QStringList parameterNames;
+        for (const SweepAxis& axis : m_axes)
+        {
+            parameterNames.append(axis.getName());
+        }
+
+        QStringList statNames;
+        for (const QPair<StatType, int>& stat : m_stats)
+        {
+            statNames.append(StatFactory::getName(stat.first, stat.second));
+        }
+
+        m_resultWriter->writeHeader(parameterNames, statNames);
+    }
+
+    int threadCount = m_threadCount;
+    if (threadCount == 0)
+    {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    WorkStealingPool pool(std::max(1, std::min(threadCount, jobCount)));
+
+    std::vector<std::unique_ptr<Simulation>> simulations(pool.getThreadCount());
+    for (std::unique_ptr<Simulation>& simulation : simulations)
+    {
+        simulation.reset(new Simulation());
+        simulation->setInstance(m_instance);
+        if (m_simulationSetup)
+        {
+            m_simulationSetup(*simulation);
+        }
+    }
+
+    double* values = m_values.data();
+    pool.run(jobCount, [this, &simulations, values](int worker, int job)
+    {
+        runJob(*simulations[worker], job, values + job * m_stats.size());
+    });
+
+    for (int point = 0; point < pointCount; ++point)
+    {
+        for (int replication = 0; replication < m_replicationCount; ++replication)
+        {
+            int job = point * m_replicationCount + replication;
+            for (int i = 0; i < statCount; ++i)
+            {
+                m_summaries[point * statCount + i].add(m_values.at(job * statCount + i));
+            }
+        }
+    }
+}
+
+const WelfordAccumulator& ParameterSweep::getSummary(int pointIndex, int statIndex) const
+{
+    return m_summaries.at(pointIndex * m_stats.size() + statIndex);
+}
+
+void ParameterSweep::runJob(Simulation& simulation, int job, double* values)
+{
+    int pointIndex = job / m_replicationCount;
+    int replication = job % m_replicationCount;
+    QVector<double> pointValues = getPointValues(pointIndex);
+
+    applyPoint(simulation, pointValues);
+    simulation.setRandomSeed(m_randomSeed, replication);
+    simulation.reset();
+
+    StatsCollector collector;
+    for (const QPair<StatType, int>& stat : m_stats)
+    {
+        collector.addStat(stat.first, stat.second);
+    }
+
+    simulation.addEventListener(&collector);
+    simulation.run(m_stopCondition);
+    simulation.removeEventListener(&collector);
+
+    SweepResult result;
+    result.pointIndex = pointIndex;
+    result.replication = replication;
+    result.parameterValues = pointValues;
+
+    for (int i = 0; i < collector.getStatCount(); ++i)
+    {
+        values[i] = collector.getValue(i);
+        result.statValues.append(values[i]);
+    }
+
+    if (m_resultWriter != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_resultWriter->write(result);
+    }
+}
+
+// Only the numbers change between points, so the stations, connection graph
+// and routing tables built by setInstance() are patched instead of rebuilt
+void ParameterSweep::applyPoint(Simulation& simulation, const QVector<double>& values) const
+{
+    for (int i = 0; i < m_axes.size(); ++i)
+    {
+        const SweepAxis& axis = m_axes.at(i);
+        double value = values.at(i);
+
+        switch (axis.parameter)
+        {
+            case SweepParameter::ArrivalParam1:
+            {
+                Distribution distribution = simulation.getArrivalDistribution();
+                distribution.param1 = value;
+                simulation.changeArrivalDistribution(distribution);
+                break;
+            }
+
+            case SweepParameter::ProcessorCount:
+            case SweepParameter::QueueLength:
+            {
+                StationParams params = simulation.getStation(axis.stationId);
+                int count = qRound(value);
+                if (axis.parameter == SweepParameter::ProcessorCount)
+                {
+                    params.processorCount = count;
+                }
+                else
+                {
+                    params.queueLength = count;
+                }
+                simulation.changeStation(axis.stationId, params);
+                break;
+            }
+
+            case SweepParameter::ConnectionWeight:
+                simulation.changeConnectionWeight(axis.stationId, axis.targetStationId, qRound(value));
+                break;
+        }
+    }
+}
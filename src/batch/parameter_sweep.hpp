@@ -0,0 +1,102 @@
+#pragma once
+
+#include "batch/sweep_result_writer.hpp"
+#include "engine/simulation.hpp"
+#include "engine/simulation_instance.hpp"
+#include "engine/stop_condition.hpp"
+#include "stats/stat_type.hpp"
+#include "stats/welford_accumulator.hpp"
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+#include <mutex>
+
+
+enum class SweepParameter
+{
+    ArrivalParam1,
+    ProcessorCount,
+    QueueLength,
+    ConnectionWeight
+};
+
+// Values taken by one parameter of the model. Station parameters refer to
+// stationId, connection weights to the connection from stationId to
+// targetStationId; integer parameters are rounded.
+struct SweepAxis
+{
+    SweepParameter parameter;
+    int stationId;
+    int targetStationId;
+    QVector<double> values;
+
+    SweepAxis()
+     : parameter(SweepParameter::ArrivalParam1)
+     , stationId(INVALID_STATION_ID)
+     , targetStationId(INVALID_STATION_ID)
+    {}
+
+    QString getName() const;
+};
+
+// Runs replications of a model at every point of the grid spanned by the
+// axes. All (point, replication) jobs go to a work-stealing pool and every
+// result is passed to the writer as soon as it is ready. Each thread builds
+// the model once and then only changes the swept numbers in place. The
+// random stream depends only on the replication, so all points of the grid
+// see the same random numbers.
+class ParameterSweep
+{
+public:
+    typedef std::function<void(Simulation&)> SimulationSetup;
+
+public:
+    explicit ParameterSweep(const SimulationInstance& instance);
+
+    void addAxis(const SweepAxis& axis);
+
+    void setReplicationCount(int count);
+    void setThreadCount(int count);
+    void setRandomSeed(quint64 seed);
+    void setStopCondition(const StopCondition& condition);
+    void setSimulationSetup(const SimulationSetup& setup);
+
+    void addStat(StatType type, int stationId = INVALID_STATION_ID);
+
+    // Not owned, may be null
+    void setResultWriter(SweepResultWriter* writer);
+
+    int getPointCount() const;
+    QVector<double> getPointValues(int pointIndex) const;
+
+    // Whether the axes refer to existing stations and connections and the
+    // model is valid at every point of the grid
+    bool check() const;
+
+    void run();
+
+    const WelfordAccumulator& getSummary(int pointIndex, int statIndex) const;
+
+private:
+    void runJob(Simulation& simulation, int job, double* values);
+    void applyPoint(Simulation& simulation, const QVector<double>& values) const;
+
+private:
+    SimulationInstance m_instance;
+    QList<SweepAxis> m_axes;
+    int m_replicationCount;
+    int m_threadCount;
+    quint64 m_randomSeed;
+    StopCondition m_stopCondition;
+    SimulationSetup m_simulationSetup;
+    SweepResultWriter* m_resultWriter;
+    std::mutex m_writerMutex;
+
+    QList<QPair<StatType, int>> m_stats;
+    QVector<double> m_values;
+    QVector<WelfordAccumulator> m_summaries;
+};
@@ -0,0 +1,264 @@
+#include "batch/replication_runner.hpp"
+
+#include "batch/work_stealing_pool.hpp"
+#include "stats/stat_factory.hpp"
+#include "stats/stats_collector.hpp"
+#include "stats/steady_state_stat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    // Replications are handed out to the threads in blocks of fixed size,
+    // which is even so that antithetic pairs are never split
+    const int BLOCK_SIZE = 8;
+}
+
+
+ReplicationRunner::ReplicationRunner(const SimulationInstance& instance)
+ : m_instance(instance)
+ , m_replicationCount(1)
+ , m_threadCount(0)
+ , m_randomSeed(0)
+ , m_antithetic(false)
+ , m_steadyStateInterval(0.0)
+{}
+
+void ReplicationRunner::setReplicationCount(int count)
+{
+    m_replicationCount = roundReplicationCount(std::max(count, 1));
+}
+
+int ReplicationRunner::getReplicationCount() const
+{
+    return m_replicationCount;
+}
+
+void ReplicationRunner::setThreadCount(int count)
+{
+    m_threadCount = std::max(count, 0);
+}
+
+void ReplicationRunner::setRandomSeed(quint64 seed)
+{
+    m_randomSeed = seed;
+}
+
+void ReplicationRunner::setAntithetic(bool antithetic)
+{
+    m_antithetic = antithetic;
+    m_replicationCount = roundReplicationCount(m_replicationCount);
+}
+
+bool ReplicationRunner::isAntithetic() const
+{
+    return m_antithetic;
+}
+
+int ReplicationRunner::roundReplicationCount(int count) const
+{
+    return m_antithetic ? count + count % 2 : count;
+}
+
+void ReplicationRunner::setSteadyStateInterval(double observationInterval)
+{
+    m_steadyStateInterval = std::max(observationInterval, 0.0);
+}
+
+double ReplicationRunner::getSteadyStateInterval() const
+{
+    return m_steadyStateInterval;
+}
+
+void ReplicationRunner::setStopCondition(const StopCondition& condition)
+{
+    m_stopCondition = condition;
+}
+
+void ReplicationRunner::setSimulationSetup(const SimulationSetup& setup)
+{
+    m_simulationSetup = setup;
+}
+
+void ReplicationRunner::addStat(StatType type, int stationId)
+{
+    m_stats.append(qMakePair(type, stationId));
+}
+
+int ReplicationRunner::getStatCount() const
+{
+    return m_stats.size();
+}
+
+QString ReplicationRunner::getStatName(int index) const
+{
+    return StatFactory::getName(m_stats.at(index).first, m_stats.at(index).second);
+}
+
+void ReplicationRunner::run()
+{
+    m_values.clear();
+    m_blockSummaries.clear();
+
+    runReplications(0, m_replicationCount);
+}
+
+// Runs rounds of replications, each at least half as large as all the
+// previous ones together, until the confidence interval of the stat is
+// narrow enough or maxReplicationCount replications have been run
+bool ReplicationRunner::runUntilPrecision(int statIndex,
+                                          double relativePrecision,
+                                          double confidenceLevel,
+                                          int maxReplicationCount)
+{
+    // Two pairs are needed for a confidence interval in antithetic mode
+    int minReplicationCount = m_antithetic ? 4 : 2;
+    maxReplicationCount = roundReplicationCount(std::max(maxReplicationCount, minReplicationCount));
+
+    m_replicationCount = std::min(std::max(m_replicationCount, minReplicationCount), maxReplicationCount);
+    run();
+
+    while (!hasPrecision(statIndex, relativePrecision, confidenceLevel) &&
+           m_replicationCount < maxReplicationCount)
+    {
+        int first = m_replicationCount;
+        int roundSize = roundReplicationCount(std::max(first / 2, getUsedThreadCount()));
+        m_replicationCount = std::min(first + roundSize, maxReplicationCount);
+
+        runReplications(first, m_replicationCount);
+    }
+
+    return hasPrecision(statIndex, relativePrecision, confidenceLevel);
+}
+
+bool ReplicationRunner::hasPrecision(int statIndex, double relativePrecision, double confidenceLevel) const
+{
+    const WelfordAccumulator& summary = getSummary(statIndex);
+    return summary.getCount() >= 2 &&
+           summary.getConfidenceHalfWidth(confidenceLevel) <= relativePrecision * std::fabs(summary.getMean());
+}
+
+// Each block of replications is summarized by the thread which ran it and
+// the block summaries are merged in block order afterwards. Block bounds
+// are fixed, so the result does not depend on how the blocks were spread
+// over the threads, nor on how the replications were split into rounds.
+void ReplicationRunner::runReplications(int first, int last)
+{
+    int statCount = m_stats.size();
+    int threadCount = getUsedThreadCount();
+    int firstBlock = first / BLOCK_SIZE;
+    int blockCount = (last + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    m_values.resize(last * statCount);
+    m_blockSummaries.resize(blockCount * statCount);
+
+    // Raw pointers, so that the threads never touch the containers themselves
+    double* allValues = m_values.data();
+    WelfordAccumulator* allBlockSummaries = m_blockSummaries.data();
+
+    WorkStealingPool pool(std::min(threadCount, blockCount - firstBlock));
+    pool.run(blockCount - firstBlock, [&](int, int job)
+    {
+        int block = firstBlock + job;
+        int blockFirst = std::max(first, block * BLOCK_SIZE);
+        int blockLast = std::min(last, (block + 1) * BLOCK_SIZE);
+
+        for (int replication = blockFirst; replication < blockLast; ++replication)
+        {
+            double* values = allValues + replication * statCount;
+            runReplication(replication, values);
+
+            if (!m_antithetic)
+            {
+                for (int i = 0; i < statCount; ++i)
+                {
+                    allBlockSummaries[block * statCount + i].add(values[i]);
+                }
+            }
+            else if (replication % 2 == 1)
+            {
+                const double* pairValues = values - statCount;
+                for (int i = 0; i < statCount; ++i)
+                {
+                    allBlockSummaries[block * statCount + i].add((pairValues[i] + values[i]) / 2.0);
+                }
+            }
+        }
+    });
+
+    m_summaries.fill(WelfordAccumulator(), statCount);
+    for (int block = 0; block < blockCount; ++block)
+    {
+        for (int i = 0; i < statCount; ++i)
+        {
+            m_summaries[i].merge(m_blockSummaries.at(block * statCount + i));
+        }
+    }
+}
+
+double ReplicationRunner::getValue(int replication, int statIndex) const
+{
+    return m_values.at(replication * m_stats.size() + statIndex);
+}
+
+const WelfordAccumulator& ReplicationRunner::getSummary(int statIndex) const
+{
+    return m_summaries.at(statIndex);
+}
+
+void ReplicationRunner::runReplication(int replication, double* values) const
+{
+    StatsCollector collector;
+    for (const QPair<StatType, int>& stat : m_stats)
+    {
+        if (m_steadyStateInterval > 0.0)
+        {
+            Stat* baseStat = StatFactory::createStat(stat.first, stat.second);
+            collector.addStat(StatFactory::getName(stat.first, stat.second),
+                              new SteadyStateStat(baseStat, m_steadyStateInterval));
+        }
+        else
+        {
+            collector.addStat(stat.first, stat.second);
+        }
+    }
+
+    Simulation simulation;
+    simulation.setInstance(m_instance);
+    if (m_simulationSetup)
+    {
+        m_simulationSetup(simulation);
+    }
+    if (m_antithetic)
+    {
+        simulation.setSamplingMethod(SamplingMethod::InverseTransform);
+        simulation.setAntithetic(replication % 2 == 1);
+        simulation.setRandomSeed(m_randomSeed, replication / 2);
+    }
+    else
+    {
+        simulation.setRandomSeed(m_randomSeed, replication);
+    }
+    simulation.reset();
+
+    simulation.addEventListener(&collector);
+    simulation.run(m_stopCondition);
+
+    for (int i = 0; i < collector.getStatCount(); ++i)
+    {
+        values[i] = collector.getValue(i);
+    }
+}
+
+int ReplicationRunner::getUsedThreadCount() const
+{
+    int threadCount = m_threadCount;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    return std::min(threadCount, m_replicationCount);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "engine/simulation.hpp"
+#include "engine/simulation_instance.hpp"
+#include "engine/stop_condition.hpp"
+#include "stats/stat_type.hpp"
+#include "stats/welford_accumulator.hpp"
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+
+// Runs independent replications of a model on a pool of threads. Every
+// replication gets its own Simulation and its own random stream, derived
+// from the common seed and the replication number, so the results do not
+// depend on the number of threads. Final values of the requested stats are
+// kept per replication and summarized per stat.
+//
+// In antithetic mode replications come in pairs sharing a random stream,
+// the second one of a pair using 1 - U for every uniform U. The summaries
+// are then built from the averages of the pairs.
+//
+// With a steady-state observation interval every stat is wrapped in a
+// SteadyStateStat, so each replication reports its mean after the warm-up.
+class ReplicationRunner
+{
+public:
+    // Called for every replication after the model has been set, e.g. to
+    // pick the event queue or to change parameters of the model
+    typedef std::function<void(Simulation&)> SimulationSetup;
+
+public:
+    explicit ReplicationRunner(const SimulationInstance& instance);
+
+    void setReplicationCount(int count);
+    int getReplicationCount() const;
+
+    // Zero means one thread per hardware thread
+    void setThreadCount(int count);
+    void setRandomSeed(quint64 seed);
+
+    // Rounds the replication count up to an even number
+    void setAntithetic(bool antithetic);
+    bool isAntithetic() const;
+
+    // Zero, the default, keeps the means from time zero
+    void setSteadyStateInterval(double observationInterval);
+    double getSteadyStateInterval() const;
+
+    // The predicate, if any, is called from several threads at once
+    void setStopCondition(const StopCondition& condition);
+    void setSimulationSetup(const SimulationSetup& setup);
+
+    void addStat(StatType type, int stationId = INVALID_STATION_ID);
+    int getStatCount() const;
+    QString getStatName(int index) const;
+
+    void run();
+
+    // Adds replications until the confidence interval half width of the
+    // given stat is at most relativePrecision times its mean; returns
+    // whether that was reached within maxReplicationCount replications
+    bool runUntilPrecision(int statIndex,
+                           double relativePrecision,
+                           double confidenceLevel,
+                           int maxReplicationCount);
+
+    double getValue(int replication, int statIndex) const;
+    const WelfordAccumulator& getSummary(int statIndex) const;
+
+private:
+    int roundReplicationCount(int count) const;
+    bool hasPrecision(int statIndex, double relativePrecision, double confidenceLevel) const;
+    void runReplications(int first, int last);
+    void runReplication(int replication, double* values) const;
+    int getUsedThreadCount() const;
+
+private:
+    SimulationInstance m_instance;
+    int m_replicationCount;
+    int m_threadCount;
+    quint64 m_randomSeed;
+    bool m_antithetic;
+    double m_steadyStateInterval;
+    StopCondition m_stopCondition;
+    SimulationSetup m_simulationSetup;
+
+    QList<QPair<StatType, int>> m_stats;
+    QVector<double> m_values;
+    QVector<WelfordAccumulator> m_blockSummaries;
+    QVector<WelfordAccumulator> m_summaries;
+};
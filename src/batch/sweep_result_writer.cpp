@@ -0,0 +1,100 @@
+#include "batch/sweep_result_writer.hpp"
+
+
+CsvSweepResultWriter::CsvSweepResultWriter(const QString& path)
+ : m_file(path)
+{
+    if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        m_out.setDevice(&m_file);
+    }
+}
+
+bool CsvSweepResultWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void CsvSweepResultWriter::writeHeader(const QStringList& parameterNames, const QStringList& statNames)
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    m_out << "point,replication";
+    for (const QString& name : parameterNames + statNames)
+    {
+        m_out << ",\"" << name << "\"";
+    }
+    m_out << "\n";
+    m_out.flush();
+}
+
+void CsvSweepResultWriter::write(const SweepResult& result)
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    m_out << result.pointIndex << "," << result.replication;
+    for (double value : result.parameterValues + result.statValues)
+    {
+        m_out << "," << QString::number(value, 'g', 17);
+    }
+    m_out << "\n";
+    m_out.flush();
+}
+
+//////////////////////////////////////
+
+const quint32 BinarySweepResultWriter::MAGIC;
+const quint32 BinarySweepResultWriter::VERSION;
+
+BinarySweepResultWriter::BinarySweepResultWriter(const QString& path)
+ : m_file(path)
+{
+    if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        m_out.setDevice(&m_file);
+        m_out.setByteOrder(QDataStream::LittleEndian);
+        m_out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    }
+}
+
+bool BinarySweepResultWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void BinarySweepResultWriter::writeHeader(const QStringList& parameterNames, const QStringList& statNames)
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    m_out << MAGIC << VERSION;
+    m_out << static_cast<qint32>(parameterNames.size()) << static_cast<qint32>(statNames.size());
+    for (const QString& name : parameterNames + statNames)
+    {
+        m_out << name;
+    }
+    m_file.flush();
+}
+
+void BinarySweepResultWriter::write(const SweepResult& result)
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    m_out << static_cast<qint32>(result.pointIndex) << static_cast<qint32>(result.replication);
+    for (double value : result.parameterValues + result.statValues)
+    {
+        m_out << value;
+    }
+    m_file.flush();
+}
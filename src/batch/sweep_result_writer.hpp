@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+
+// Stat values of one replication at one point of a parameter sweep
+struct SweepResult
+{
+    int pointIndex;
+    int replication;
+    QVector<double> parameterValues;
+    QVector<double> statValues;
+};
+
+// Receives sweep results as soon as they are ready, so in no particular
+// order; calls are never made from two threads at once
+class SweepResultWriter
+{
+public:
+    virtual ~SweepResultWriter() {}
+
+    virtual void writeHeader(const QStringList& parameterNames, const QStringList& statNames) = 0;
+    virtual void write(const SweepResult& result) = 0;
+};
+
+//////////////////////////////////////
+
+// One line per result: point, replication, parameter values, stat values
+class CsvSweepResultWriter : public SweepResultWriter
+{
+public:
+    explicit CsvSweepResultWriter(const QString& path);
+
+    bool isOpen() const;
+
+    virtual void writeHeader(const QStringList& parameterNames, const QStringList& statNames) override;
+    virtual void write(const SweepResult& result) override;
+
+private:
+    QFile m_file;
+    QTextStream m_out;
+};
+
+//////////////////////////////////////
+
+// Little-endian QDataStream: magic, version, parameter and stat counts and
+// names, followed by records of point and replication (qint32) and all the
+// values (double)
+class BinarySweepResultWriter : public SweepResultWriter
+{
+public:
+    static const quint32 MAGIC = 0x50575351;
+    static const quint32 VERSION = 1;
+
+public:
+    explicit BinarySweepResultWriter(const QString& path);
+
+    bool isOpen() const;
+
+    virtual void writeHeader(const QStringList& parameterNames, const QStringList& statNames) override;
+    virtual void write(const SweepResult& result) override;
+
+private:
+    QFile m_file;
+    QDataStream m_out;
+};
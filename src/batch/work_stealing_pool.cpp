@@ -0,0 +1,97 @@
+#include "batch/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+ : m_threadCount(threadCount)
+{
+    if (m_threadCount <= 0)
+    {
+        m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    for (int i = 0; i < m_threadCount; ++i)
+    {
+        m_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+}
+
+int WorkStealingPool::getThreadCount() const
+{
+    return m_threadCount;
+}
+
+void WorkStealingPool::run(int jobCount, const JobFunction& function)
+{
+    for (int i = 0; i < m_threadCount; ++i)
+    {
+        int first = static_cast<int>(static_cast<long long>(jobCount) * i / m_threadCount);
+        int last = static_cast<int>(static_cast<long long>(jobCount) * (i + 1) / m_threadCount);
+
+        std::deque<int>& jobs = m_queues[i]->jobs;
+        jobs.clear();
+        for (int job = first; job < last; ++job)
+        {
+            jobs.push_back(job);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < m_threadCount; ++i)
+    {
+        threads.push_back(std::thread(&WorkStealingPool::work, this, i, std::cref(function)));
+    }
+
+    work(0, function);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::work(int worker, const JobFunction& function)
+{
+    int job;
+    while (takeOwnJob(worker, job) || stealJob(worker, job))
+    {
+        function(worker, job);
+    }
+}
+
+bool WorkStealingPool::takeOwnJob(int worker, int& job)
+{
+    WorkerQueue& queue = *m_queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.jobs.empty())
+    {
+        return false;
+    }
+
+    job = queue.jobs.front();
+    queue.jobs.pop_front();
+    return true;
+}
+
+// Jobs are never added while running, so a thread which finds all other
+// queues empty can finish
+bool WorkStealingPool::stealJob(int worker, int& job)
+{
+    for (int i = 1; i < m_threadCount; ++i)
+    {
+        WorkerQueue& queue = *m_queues[(worker + i) % m_threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.jobs.empty())
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
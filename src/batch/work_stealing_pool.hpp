@@ -0,0 +1,41 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+// Runs a number of jobs on a fixed set of threads. Jobs are split into
+// contiguous ranges, one per thread; each thread takes its own jobs in order
+// and, once out of them, steals from the end of another thread's range.
+class WorkStealingPool
+{
+public:
+    // Called with the number of the thread running the job, in [0, threadCount)
+    typedef std::function<void(int worker, int job)> JobFunction;
+
+public:
+    explicit WorkStealingPool(int threadCount);
+
+    int getThreadCount() const;
+
+    void run(int jobCount, const JobFunction& function);
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<int> jobs;
+    };
+
+private:
+    void work(int worker, const JobFunction& function);
+    bool takeOwnJob(int worker, int& job);
+    bool stealJob(int worker, int& job);
+
+private:
+    int m_threadCount;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+};
@@ -0,0 +1,558 @@
+#include "batch/parameter_sweep.hpp"
+#include "batch/replication_runner.hpp"
+#include "batch/sweep_result_writer.hpp"
+
+#include "engine/simulation.hpp"
+#include "engine/simulation_input_output_helper.hpp"
+
+#include "stats/stat_factory.hpp"
+#include "stats/sequential_stopping_rule.hpp"
+#include "stats/stats_collector.hpp"
+#include "stats/steady_state_stat.hpp"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include <memory>
+
+namespace
+{
+    struct CommandLine
+    {
+        QString modelPath;
+        double horizon = 0.0;
+        EventQueueType eventQueueType = EventQueueType::Heap;
+        bool fusedTransitions = false;
+        int replicationCount = 1;
+        bool antithetic = false;
+        int threadCount = 0;
+        quint64 randomSeed = 0;
+        RandomGeneratorType randomGeneratorType = RandomGeneratorType::MersenneTwister;
+        double steadyStateInterval = 0.0;
+        double relativePrecision = 0.0;
+        QList<SweepAxis> sweepAxes;
+        QString sweepOutputPath;
+    };
+
+    const double CONFIDENCE_LEVEL = 0.95;
+
+    // Stat on which a --precision target is checked
+    const StatType PRECISION_STAT_TYPE = StatType::SystemMeanTaskProcessingTime;
+
+    void printUsage(QTextStream& out)
+    {
+        out << "Usage: queues-cli [--event-queue=heap|calendar|radix] [--fused]\n"
+            << "                  [--replications=N] [--antithetic] [--threads=N] [--seed=N]\n"
+            << "                  [--generator=mt|xoshiro]\n"
+            << "                  [--steady-state=OBSERVATION_INTERVAL] [--precision=RELATIVE_PRECISION]\n"
+            << "                  [--sweep=PARAMETER=VALUE,VALUE,...]... [--sweep-output=FILE.csv|FILE.bin]\n"
+            << "                  MODEL_FILE HORIZON\n"
+            << "\n"
+            << "Sweep parameters: arrival, processors:STATION, queue:STATION, weight:FROM-TO\n";
+    }
+
+    // "processors:3=1,2,4" sweeps the number of processors of station 3
+    bool parseSweepAxis(const QString& text, SweepAxis& axis)
+    {
+        int separator = text.indexOf('=');
+        if (separator < 0)
+        {
+            return false;
+        }
+
+        QStringList target = text.left(separator).split(':');
+        QString parameter = target.at(0);
+        bool ok = true;
+        if (parameter == "arrival" && target.size() == 1)
+        {
+            axis.parameter = SweepParameter::ArrivalParam1;
+        }
+        else if ((parameter == "processors" || parameter == "queue") && target.size() == 2)
+        {
+            axis.parameter = parameter == "processors" ? SweepParameter::ProcessorCount
+                                                       : SweepParameter::QueueLength;
+            axis.stationId = target.at(1).toInt(&ok);
+        }
+        else if (parameter == "weight" && target.size() == 2)
+        {
+            QStringList stationIds = target.at(1).split('-');
+            if (stationIds.size() != 2)
+            {
+                return false;
+            }
+
+            axis.parameter = SweepParameter::ConnectionWeight;
+            bool targetOk = false;
+            axis.stationId = stationIds.at(0).toInt(&ok);
+            axis.targetStationId = stationIds.at(1).toInt(&targetOk);
+            ok = ok && targetOk;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+
+        for (const QString& valueText : text.mid(separator + 1).split(','))
+        {
+            double value = valueText.toDouble(&ok);
+            if (!ok)
+            {
+                return false;
+            }
+            axis.values.append(value);
+        }
+
+        return true;
+    }
+
+    bool parseCommandLine(const QStringList& arguments, CommandLine& commandLine)
+    {
+        QStringList positional;
+        for (const QString& argument : arguments)
+        {
+            if (argument == "--fused")
+            {
+                commandLine.fusedTransitions = true;
+            }
+            else if (argument == "--antithetic")
+            {
+                commandLine.antithetic = true;
+            }
+            else if (argument.startsWith("--event-queue="))
+            {
+                QString type = argument.mid(QString("--event-queue=").size());
+                if (type == "heap")
+                {
+                    commandLine.eventQueueType = EventQueueType::Heap;
+                }
+                else if (type == "calendar")
+                {
+                    commandLine.eventQueueType = EventQueueType::Calendar;
+                }
+                else if (type == "radix")
+                {
+                    commandLine.eventQueueType = EventQueueType::RadixHeap;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--replications="))
+            {
+                bool ok = false;
+                commandLine.replicationCount = argument.mid(QString("--replications=").size()).toInt(&ok);
+                if (!ok || commandLine.replicationCount < 1)
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--threads="))
+            {
+                bool ok = false;
+                commandLine.threadCount = argument.mid(QString("--threads=").size()).toInt(&ok);
+                if (!ok || commandLine.threadCount < 0)
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--seed="))
+            {
+                bool ok = false;
+                commandLine.randomSeed = argument.mid(QString("--seed=").size()).toULongLong(&ok);
+                if (!ok)
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--generator="))
+            {
+                QString type = argument.mid(QString("--generator=").size());
+                if (type == "mt")
+                {
+                    commandLine.randomGeneratorType = RandomGeneratorType::MersenneTwister;
+                }
+                else if (type == "xoshiro")
+                {
+                    commandLine.randomGeneratorType = RandomGeneratorType::Xoshiro256PlusPlus;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--steady-state="))
+            {
+                bool ok = false;
+                commandLine.steadyStateInterval = argument.mid(QString("--steady-state=").size()).toDouble(&ok);
+                if (!ok || commandLine.steadyStateInterval <= 0.0)
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--precision="))
+            {
+                bool ok = false;
+                commandLine.relativePrecision = argument.mid(QString("--precision=").size()).toDouble(&ok);
+                if (!ok || commandLine.relativePrecision <= 0.0)
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--sweep="))
+            {
+                SweepAxis axis;
+                if (!parseSweepAxis(argument.mid(QString("--sweep=").size()), axis))
+                {
+                    return false;
+                }
+                commandLine.sweepAxes.append(axis);
+            }
+            else if (argument.startsWith("--sweep-output="))
+            {
+                commandLine.sweepOutputPath = argument.mid(QString("--sweep-output=").size());
+            }
+            else if (argument.startsWith("--"))
+            {
+                return false;
+            }
+            else
+            {
+                positional.append(argument);
+            }
+        }
+
+        if (positional.size() != 2 || (commandLine.sweepAxes.isEmpty() && !commandLine.sweepOutputPath.isEmpty()))
+        {
+            return false;
+        }
+
+        bool ok = false;
+        commandLine.modelPath = positional.at(0);
+        commandLine.horizon = positional.at(1).toDouble(&ok);
+        return ok && commandLine.horizon > 0.0;
+    }
+
+    // Every stat type, station stats for every working station
+    QList<QPair<StatType, int>> getAllStats(const SimulationInstance& instance)
+    {
+        QList<QPair<StatType, int>> stats;
+        for (StatType type : StatFactory::getTypes())
+        {
+            if (!StatFactory::isStationStat(type))
+            {
+                stats.append(qMakePair(type, INVALID_STATION_ID));
+                continue;
+            }
+
+            for (const Station& station : instance.stations)
+            {
+                if (station.id != INPUT_STATION_ID && station.id != OUTPUT_STATION_ID)
+                {
+                    stats.append(qMakePair(type, station.id));
+                }
+            }
+        }
+        return stats;
+    }
+
+    void setupSimulation(const CommandLine& commandLine, Simulation& simulation)
+    {
+        simulation.setEventQueueType(commandLine.eventQueueType);
+        simulation.setFusedTransitions(commandLine.fusedTransitions);
+        simulation.setRandomGeneratorType(commandLine.randomGeneratorType);
+    }
+
+    void runSingle(const CommandLine& commandLine, const SimulationInstance& instance, QTextStream& out)
+    {
+        bool steadyState = commandLine.steadyStateInterval > 0.0;
+
+        StatsCollector collector;
+        for (const QPair<StatType, int>& stat : getAllStats(instance))
+        {
+            if (steadyState)
+            {
+                Stat* baseStat = StatFactory::createStat(stat.first, stat.second);
+                collector.addStat(StatFactory::getName(stat.first, stat.second),
+                                  new SteadyStateStat(baseStat, commandLine.steadyStateInterval));
+            }
+            else
+            {
+                collector.addStat(stat.first, stat.second);
+            }
+        }
+
+        Simulation simulation;
+        setupSimulation(commandLine, simulation);
+        simulation.setInstance(instance);
+        simulation.setRandomSeed(commandLine.randomSeed);
+        simulation.reset();
+        simulation.addEventListener(&collector);
+
+        // With a precision target the horizon is only an upper bound
+        double observationInterval = steadyState ? commandLine.steadyStateInterval
+                                                 : SequentialStoppingRule::DEFAULT_OBSERVATION_INTERVAL;
+        SequentialStoppingRule stoppingRule(PRECISION_STAT_TYPE, INVALID_STATION_ID, commandLine.relativePrecision,
+                                            CONFIDENCE_LEVEL, observationInterval);
+
+        StopCondition stopCondition;
+        stopCondition.timeLimit = commandLine.horizon;
+        if (commandLine.relativePrecision > 0.0)
+        {
+            simulation.addEventListener(&stoppingRule);
+            stopCondition.predicate = [&stoppingRule](const Simulation&)
+            {
+                return stoppingRule.isSatisfied();
+            };
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        simulation.run(stopCondition);
+        qint64 elapsed = timer.elapsed();
+
+        if (commandLine.relativePrecision > 0.0)
+        {
+            out << "precision " << (stoppingRule.isSatisfied() ? "reached" : "not reached")
+                << "\t" << QString::number(stoppingRule.getMean(), 'g', 10)
+                << "\t" << QString::number(stoppingRule.getHalfWidth(), 'g', 10) << "\n";
+        }
+
+        out << "time\t" << simulation.getCurrentTime() << "\n";
+        out << "events\t" << simulation.getProcessedEventCount() << "\n";
+        out << "completed tasks\t" << simulation.getCompletedTaskCount() << "\n";
+        if (steadyState)
+        {
+            out << "stat\tmean\tci" << qRound(CONFIDENCE_LEVEL * 100) << "\twarm-up\n";
+        }
+
+        for (int i = 0; i < collector.getStatCount(); ++i)
+        {
+            out << collector.getName(i) << "\t" << QString::number(collector.getValue(i), 'g', 10);
+            if (steadyState)
+            {
+                const SteadyStateStat* stat = static_cast<const SteadyStateStat*>(collector.getStat(i));
+                out << "\t" << QString::number(stat->getConfidenceHalfWidth(CONFIDENCE_LEVEL), 'g', 10)
+                    << "\t" << QString::number(stat->getWarmUpTime(), 'g', 10);
+            }
+            out << "\n";
+        }
+        out << "elapsed ms\t" << elapsed << "\n";
+    }
+
+    bool runReplications(const CommandLine& commandLine, const SimulationInstance& instance, QTextStream& out,
+                         QTextStream& err)
+    {
+        ReplicationRunner runner(instance);
+        runner.setAntithetic(commandLine.antithetic);
+        runner.setReplicationCount(commandLine.replicationCount);
+        runner.setThreadCount(commandLine.threadCount);
+        runner.setRandomSeed(commandLine.randomSeed);
+        runner.setSteadyStateInterval(commandLine.steadyStateInterval);
+
+        StopCondition stopCondition;
+        stopCondition.timeLimit = commandLine.horizon;
+        runner.setStopCondition(stopCondition);
+        runner.setSimulationSetup([&commandLine](Simulation& simulation)
+        {
+            setupSimulation(commandLine, simulation);
+        });
+
+        int precisionStatIndex = -1;
+        for (const QPair<StatType, int>& stat : getAllStats(instance))
+        {
+            if (stat.first == PRECISION_STAT_TYPE && stat.second == INVALID_STATION_ID)
+            {
+                precisionStatIndex = runner.getStatCount();
+            }
+            runner.addStat(stat.first, stat.second);
+        }
+
+        if (commandLine.relativePrecision > 0.0 && precisionStatIndex < 0)
+        {
+            err << "Precision stat is not collected\n";
+            return false;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        if (commandLine.relativePrecision > 0.0)
+        {
+            runner.setReplicationCount(0);
+            bool reached = runner.runUntilPrecision(precisionStatIndex, commandLine.relativePrecision, CONFIDENCE_LEVEL,
+                                                    commandLine.replicationCount);
+            out << "precision " << (reached ? "reached" : "not reached") << "\n";
+        }
+        else
+        {
+            runner.run();
+        }
+        qint64 elapsed = timer.elapsed();
+
+        out << "stat\tmean\tstddev\tci" << qRound(CONFIDENCE_LEVEL * 100) << "\n";
+        for (int i = 0; i < runner.getStatCount(); ++i)
+        {
+            const WelfordAccumulator& summary = runner.getSummary(i);
+            out << runner.getStatName(i)
+                << "\t" << QString::number(summary.getMean(), 'g', 10)
+                << "\t" << QString::number(summary.getStandardDeviation(), 'g', 10)
+                << "\t" << QString::number(summary.getConfidenceHalfWidth(CONFIDENCE_LEVEL), 'g', 10) << "\n";
+        }
+        out << "replications\t" << runner.getReplicationCount() << "\n";
+        out << "elapsed ms\t" << elapsed << "\n";
+        return true;
+    }
+
+    bool runSweep(const CommandLine& commandLine, const SimulationInstance& instance, QTextStream& out,
+                  QTextStream& err)
+    {
+        ParameterSweep sweep(instance);
+        for (const SweepAxis& axis : commandLine.sweepAxes)
+        {
+            sweep.addAxis(axis);
+        }
+
+        sweep.setReplicationCount(commandLine.replicationCount);
+        sweep.setThreadCount(commandLine.threadCount);
+        sweep.setRandomSeed(commandLine.randomSeed);
+
+        StopCondition stopCondition;
+        stopCondition.timeLimit = commandLine.horizon;
+        sweep.setStopCondition(stopCondition);
+        sweep.setSimulationSetup([&commandLine](Simulation& simulation)
+        {
+            setupSimulation(commandLine, simulation);
+        });
+
+        QList<QPair<StatType, int>> stats = getAllStats(instance);
+        for (const QPair<StatType, int>& stat : stats)
+        {
+            sweep.addStat(stat.first, stat.second);
+        }
+
+        if (!sweep.check())
+        {
+            err << "Invalid sweep, the model is not valid at every point\n";
+            return false;
+        }
+
+        // Per-replication results go to the file, the summaries to stdout
+        std::unique_ptr<SweepResultWriter> writer;
+        const QString& path = commandLine.sweepOutputPath;
+        if (path.endsWith(".bin"))
+        {
+            BinarySweepResultWriter* binaryWriter = new BinarySweepResultWriter(path);
+            writer.reset(binaryWriter);
+            if (!binaryWriter->isOpen())
+            {
+                err << "Cannot open " << path << "\n";
+                return false;
+            }
+        }
+        else if (!path.isEmpty())
+        {
+            CsvSweepResultWriter* csvWriter = new CsvSweepResultWriter(path);
+            writer.reset(csvWriter);
+            if (!csvWriter->isOpen())
+            {
+                err << "Cannot open " << path << "\n";
+                return false;
+            }
+        }
+        sweep.setResultWriter(writer.get());
+
+        QElapsedTimer timer;
+        timer.start();
+        sweep.run();
+        qint64 elapsed = timer.elapsed();
+
+        out << "stat\tmean\tstddev\tci" << qRound(CONFIDENCE_LEVEL * 100) << "\n";
+        for (int point = 0; point < sweep.getPointCount(); ++point)
+        {
+            QVector<double> values = sweep.getPointValues(point);
+            out << "point " << point;
+            for (int i = 0; i < values.size(); ++i)
+            {
+                out << "\t" << commandLine.sweepAxes.at(i).getName() << "=" << QString::number(values.at(i), 'g', 10);
+            }
+            out << "\n";
+
+            for (int i = 0; i < stats.size(); ++i)
+            {
+                const WelfordAccumulator& summary = sweep.getSummary(point, i);
+                out << StatFactory::getName(stats.at(i).first, stats.at(i).second)
+                    << "\t" << QString::number(summary.getMean(), 'g', 10)
+                    << "\t" << QString::number(summary.getStandardDeviation(), 'g', 10)
+                    << "\t" << QString::number(summary.getConfidenceHalfWidth(CONFIDENCE_LEVEL), 'g', 10) << "\n";
+            }
+        }
+        out << "replications\t" << commandLine.replicationCount << "\n";
+        out << "elapsed ms\t" << elapsed << "\n";
+        return true;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList arguments;
+    for (int i = 1; i < argc; ++i)
+    {
+        arguments.append(QString::fromLocal8Bit(argv[i]));
+    }
+
+    CommandLine commandLine;
+    if (!parseCommandLine(arguments, commandLine))
+    {
+        printUsage(err);
+        return 2;
+    }
+
+    if (!commandLine.sweepAxes.isEmpty()
+        && (commandLine.antithetic || commandLine.steadyStateInterval > 0.0 || commandLine.relativePrecision > 0.0))
+    {
+        err << "--sweep cannot be combined with --antithetic, --steady-state or --precision\n";
+        return 2;
+    }
+
+    SimulationInstance instance = SimulationInputOutputHelper::readFromFile(commandLine.modelPath);
+    if (!Simulation::check(instance))
+    {
+        err << "Invalid model: " << commandLine.modelPath << "\n";
+        return 1;
+    }
+
+    if (!commandLine.sweepAxes.isEmpty())
+    {
+        if (!runSweep(commandLine, instance, out, err))
+        {
+            return 1;
+        }
+    }
+    else if (commandLine.replicationCount > 1 || commandLine.antithetic)
+    {
+        // Antithetic replications come in pairs, even when only one is asked for
+        if (!runReplications(commandLine, instance, out, err))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        runSingle(commandLine, instance, out);
+    }
+
+    return 0;
+}
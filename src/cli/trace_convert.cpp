@@ -0,0 +1,161 @@
+#include "engine/trace_file.hpp"
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include <cmath>
+
+namespace
+{
+    struct CommandLine
+    {
+        QString inputPath;
+        QString outputPath;
+        int column = 1;
+        bool skipHeader = false;
+        bool differences = false;
+    };
+
+    void printUsage(QTextStream& out)
+    {
+        out << "Usage: queues-trace-convert [--column=N] [--skip-header] [--differences]\n"
+            << "                            CSV_FILE TRACE_FILE\n";
+    }
+
+    bool parseCommandLine(const QStringList& arguments, CommandLine& commandLine)
+    {
+        QStringList positional;
+        for (const QString& argument : arguments)
+        {
+            if (argument == "--skip-header")
+            {
+                commandLine.skipHeader = true;
+            }
+            else if (argument == "--differences")
+            {
+                commandLine.differences = true;
+            }
+            else if (argument.startsWith("--column="))
+            {
+                bool ok = false;
+                commandLine.column = argument.mid(QString("--column=").size()).toInt(&ok);
+                if (!ok || commandLine.column < 1)
+                {
+                    return false;
+                }
+            }
+            else if (argument.startsWith("--"))
+            {
+                return false;
+            }
+            else
+            {
+                positional.append(argument);
+            }
+        }
+
+        if (positional.size() != 2)
+        {
+            return false;
+        }
+
+        commandLine.inputPath = positional[0];
+        commandLine.outputPath = positional[1];
+        return true;
+    }
+}
+
+
+// Converts a column of a CSV file to a binary trace. With --differences the
+// column holds time stamps, e.g. of arrivals, and the trace gets the times
+// between them.
+int main(int argc, char* argv[])
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList arguments;
+    for (int i = 1; i < argc; ++i)
+    {
+        arguments.append(QString::fromLocal8Bit(argv[i]));
+    }
+
+    CommandLine commandLine;
+    if (!parseCommandLine(arguments, commandLine))
+    {
+        printUsage(err);
+        return 2;
+    }
+
+    QFile input(commandLine.inputPath);
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        err << "Cannot open " << commandLine.inputPath << "\n";
+        return 1;
+    }
+
+    TraceFileWriter writer;
+    if (!writer.open(commandLine.outputPath))
+    {
+        err << "Cannot write " << commandLine.outputPath << "\n";
+        return 1;
+    }
+
+    QTextStream in(&input);
+    int lineNumber = 0;
+    bool hasPrevious = false;
+    double previous = 0.0;
+    while (!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if ((lineNumber == 1 && commandLine.skipHeader) || line.isEmpty() || line.startsWith("#"))
+        {
+            continue;
+        }
+
+        QStringList components = line.split(",");
+        bool ok = false;
+        double value = components.size() >= commandLine.column
+                       ? components[commandLine.column - 1].trimmed().toDouble(&ok) : 0.0;
+
+        if (ok && commandLine.differences)
+        {
+            double timeStamp = value;
+            value = timeStamp - previous;
+            previous = timeStamp;
+
+            // The first time stamp only starts the differences
+            if (!hasPrevious)
+            {
+                hasPrevious = true;
+                continue;
+            }
+        }
+
+        if (!ok || !std::isfinite(value) || value < 0.0)
+        {
+            err << commandLine.inputPath << ":" << lineNumber << ": invalid value\n";
+            writer.close();
+            QFile::remove(commandLine.outputPath);
+            return 1;
+        }
+
+        if (!writer.write(value))
+        {
+            err << "Cannot write " << commandLine.outputPath << "\n";
+            return 1;
+        }
+    }
+
+    if (!writer.close())
+    {
+        err << "Cannot write " << commandLine.outputPath << "\n";
+        return 1;
+    }
+
+    out << writer.getCount() << " values written to " << commandLine.outputPath << "\n";
+    return 0;
+}
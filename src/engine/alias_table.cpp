@@ -0,0 +1,69 @@
+#include "engine/alias_table.hpp"
+
+
+AliasTable::AliasTable()
+{}
+
+// Vose's variant: items below the average weight are paired with ones
+// above it, which give away the rest of the slot
+AliasTable::AliasTable(const QVector<double>& weights)
+ : m_probabilities(weights.size(), 1.0)
+ , m_aliases(weights.size())
+{
+    int count = weights.size();
+
+    double totalWeight = 0.0;
+    for (double weight : weights)
+    {
+        totalWeight += weight;
+    }
+
+    if (count == 0 || totalWeight <= 0.0)
+    {
+        return;
+    }
+
+    QVector<double> scaled(count);
+    QVector<int> small;
+    QVector<int> large;
+    for (int i = 0; i < count; ++i)
+    {
+        m_aliases[i] = i;
+        scaled[i] = weights.at(i) * count / totalWeight;
+        if (scaled.at(i) < 1.0)
+        {
+            small.append(i);
+        }
+        else
+        {
+            large.append(i);
+        }
+    }
+
+    while (!small.isEmpty() && !large.isEmpty())
+    {
+        int less = small.takeLast();
+        int more = large.last();
+
+        m_probabilities[less] = scaled.at(less);
+        m_aliases[less] = more;
+
+        scaled[more] -= 1.0 - scaled.at(less);
+        if (scaled.at(more) < 1.0)
+        {
+            large.removeLast();
+            small.append(more);
+        }
+    }
+
+    // Whatever is left is 1 up to rounding errors
+    for (int i : small + large)
+    {
+        m_probabilities[i] = 1.0;
+    }
+}
+
+int AliasTable::size() const
+{
+    return m_probabilities.size();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "engine/random_stream.hpp"
+
+#include <QVector>
+
+
+// Weighted choice among a fixed set of items in constant time with Walker's
+// alias method. Weights need not be normalized.
+class AliasTable
+{
+public:
+    AliasTable();
+    explicit AliasTable(const QVector<double>& weights);
+
+    int size() const;
+
+    int sample(RandomStream& stream) const
+    {
+        double scaled = stream.nextDouble() * m_probabilities.size();
+        int index = std::min(static_cast<int>(scaled), m_probabilities.size() - 1);
+        return scaled - index < m_probabilities.at(index) ? index : m_aliases.at(index);
+    }
+
+private:
+    QVector<double> m_probabilities;
+    QVector<int> m_aliases;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "engine/distribution.hpp"
+#include "engine/station.hpp"
+
+// Tasks arriving straight at a station, besides the ones coming through the
+// input station. A task finding the station's queue full is lost.
+struct ArrivalSource
+{
+    int stationId;
+    Distribution arrivalTimeDistribution;
+
+    ArrivalSource()
+     : stationId(INVALID_STATION_ID)
+    {}
+};
@@ -0,0 +1,109 @@
+#include "engine/arrival_source_heap.hpp"
+
+
+void ArrivalSourceHeap::clear()
+{
+    m_heap.clear();
+}
+
+void ArrivalSourceHeap::reserve(int size)
+{
+    m_heap.reserve(size);
+}
+
+bool ArrivalSourceHeap::isEmpty() const
+{
+    return m_heap.isEmpty();
+}
+
+int ArrivalSourceHeap::size() const
+{
+    return m_heap.size();
+}
+
+void ArrivalSourceHeap::push(const Entry& entry)
+{
+    m_heap.append(entry);
+    siftUp(m_heap.size() - 1);
+}
+
+const ArrivalSourceHeap::Entry& ArrivalSourceHeap::head() const
+{
+    return m_heap.first();
+}
+
+void ArrivalSourceHeap::pop()
+{
+    m_heap.first() = m_heap.last();
+    m_heap.removeLast();
+
+    if (!m_heap.isEmpty())
+    {
+        siftDown(0);
+    }
+}
+
+void ArrivalSourceHeap::replaceHeadTime(double time)
+{
+    m_heap.first().time = time;
+    siftDown(0);
+}
+
+bool ArrivalSourceHeap::isBefore(const Entry& first, const Entry& second)
+{
+    if (first.time != second.time)
+    {
+        return first.time < second.time;
+    }
+
+    return first.source < second.source;
+}
+
+void ArrivalSourceHeap::siftUp(int index)
+{
+    Entry entry = m_heap.at(index);
+
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (!isBefore(entry, m_heap.at(parent)))
+        {
+            break;
+        }
+
+        m_heap[index] = m_heap.at(parent);
+        index = parent;
+    }
+
+    m_heap[index] = entry;
+}
+
+void ArrivalSourceHeap::siftDown(int index)
+{
+    Entry entry = m_heap.at(index);
+    int size = m_heap.size();
+
+    while (true)
+    {
+        int child = 2 * index + 1;
+        if (child >= size)
+        {
+            break;
+        }
+
+        if (child + 1 < size && isBefore(m_heap.at(child + 1), m_heap.at(child)))
+        {
+            ++child;
+        }
+
+        if (!isBefore(m_heap.at(child), entry))
+        {
+            break;
+        }
+
+        m_heap[index] = m_heap.at(child);
+        index = child;
+    }
+
+    m_heap[index] = entry;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QVector>
+
+
+// Next arrival times of the arrival sources. Only the earliest arrival is
+// an event in the future event set, so thousands of sources do not make
+// that set any larger. Sources due at the same time come in the order of
+// their indices.
+class ArrivalSourceHeap
+{
+public:
+    struct Entry
+    {
+        double time;
+        int source;
+    };
+
+public:
+    void clear();
+    void reserve(int size);
+    bool isEmpty() const;
+    int size() const;
+
+    void push(const Entry& entry);
+    const Entry& head() const;
+    void pop();
+
+    // Moves the head to its next arrival time
+    void replaceHeadTime(double time);
+
+private:
+    static bool isBefore(const Entry& first, const Entry& second);
+    void siftUp(int index);
+    void siftDown(int index);
+
+private:
+    QVector<Entry> m_heap;
+};
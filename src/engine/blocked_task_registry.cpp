@@ -0,0 +1,150 @@
+#include "engine/blocked_task_registry.hpp"
+
+#include <algorithm>
+
+
+BlockedTaskRegistry::BlockedTaskRegistry()
+ : m_policy(UnblockingPolicy::Fifo)
+{}
+
+void BlockedTaskRegistry::setPolicy(UnblockingPolicy policy)
+{
+    if (policy == m_policy)
+    {
+        return;
+    }
+
+    QVector<Entry> entries = m_heap;
+    for (const Entry& entry : m_queue)
+    {
+        entries.append(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& first, const Entry& second)
+    {
+        return first.sequence < second.sequence;
+    });
+
+    clear();
+    m_policy = policy;
+
+    for (const Entry& entry : entries)
+    {
+        push(entry);
+    }
+}
+
+UnblockingPolicy BlockedTaskRegistry::getPolicy() const
+{
+    return m_policy;
+}
+
+void BlockedTaskRegistry::clear()
+{
+    m_queue.clear();
+    m_heap.clear();
+}
+
+bool BlockedTaskRegistry::isEmpty() const
+{
+    return size() == 0;
+}
+
+int BlockedTaskRegistry::size() const
+{
+    return m_policy == UnblockingPolicy::Fifo ? m_queue.size() : m_heap.size();
+}
+
+void BlockedTaskRegistry::push(const Entry& entry)
+{
+    if (m_policy == UnblockingPolicy::Fifo)
+    {
+        m_queue.enqueue(entry);
+    }
+    else
+    {
+        m_heap.append(entry);
+        siftUp(m_heap.size() - 1);
+    }
+}
+
+const BlockedTaskRegistry::Entry& BlockedTaskRegistry::head() const
+{
+    return m_policy == UnblockingPolicy::Fifo ? m_queue.head() : m_heap.first();
+}
+
+void BlockedTaskRegistry::pop()
+{
+    if (m_policy == UnblockingPolicy::Fifo)
+    {
+        m_queue.dequeue();
+        return;
+    }
+
+    m_heap.first() = m_heap.last();
+    m_heap.removeLast();
+
+    if (!m_heap.isEmpty())
+    {
+        siftDown(0);
+    }
+}
+
+bool BlockedTaskRegistry::isBefore(const Entry& first, const Entry& second)
+{
+    if (first.priority != second.priority)
+    {
+        return first.priority > second.priority;
+    }
+
+    return first.sequence < second.sequence;
+}
+
+void BlockedTaskRegistry::siftUp(int index)
+{
+    Entry entry = m_heap.at(index);
+
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (!isBefore(entry, m_heap.at(parent)))
+        {
+            break;
+        }
+
+        m_heap[index] = m_heap.at(parent);
+        index = parent;
+    }
+
+    m_heap[index] = entry;
+}
+
+void BlockedTaskRegistry::siftDown(int index)
+{
+    Entry entry = m_heap.at(index);
+    int size = m_heap.size();
+
+    while (true)
+    {
+        int child = 2 * index + 1;
+        if (child >= size)
+        {
+            break;
+        }
+
+        if (child + 1 < size && isBefore(m_heap.at(child + 1), m_heap.at(child)))
+        {
+            ++child;
+        }
+
+        if (!isBefore(m_heap.at(child), entry))
+        {
+            break;
+        }
+
+        m_heap[index] = m_heap.at(child);
+        index = child;
+    }
+
+    m_heap[index] = entry;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QQueue>
+#include <QVector>
+
+
+enum class UnblockingPolicy
+{
+    Fifo,
+    Priority
+};
+
+// Upstream tasks blocked on a station, i.e. processed tasks which could not
+// move on because the station's queue was full. With the FIFO policy they
+// are released in the order they got blocked, with the priority policy the
+// ones coming over heavier connections go first, ties broken by block order.
+class BlockedTaskRegistry
+{
+public:
+    struct Entry
+    {
+        int taskId;
+        int stationId;
+        int priority;
+        quint64 sequence;
+    };
+
+public:
+    BlockedTaskRegistry();
+
+    void setPolicy(UnblockingPolicy policy);
+    UnblockingPolicy getPolicy() const;
+
+    void clear();
+    bool isEmpty() const;
+    int size() const;
+
+    void push(const Entry& entry);
+    const Entry& head() const;
+    void pop();
+
+private:
+    static bool isBefore(const Entry& first, const Entry& second);
+    void siftUp(int index);
+    void siftDown(int index);
+
+private:
+    UnblockingPolicy m_policy;
+    QQueue<Entry> m_queue;
+    QVector<Entry> m_heap;
+};
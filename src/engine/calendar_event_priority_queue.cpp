@@ -0,0 +1,227 @@
+#include "engine/calendar_event_priority_queue.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int MIN_BUCKET_COUNT = 2;
+    const double INITIAL_BUCKET_WIDTH = 1.0;
+    const int WIDTH_SAMPLE_SIZE = 25;
+}
+
+
+CalendarEventPriorityQueue::CalendarEventPriorityQueue()
+ : m_bucketWidth(INITIAL_BUCKET_WIDTH)
+ , m_currentVirtualBucket(0)
+ , m_size(0)
+ , m_nextSequence(0)
+{
+    m_buckets.resize(MIN_BUCKET_COUNT);
+}
+
+EventQueueType CalendarEventPriorityQueue::getType() const
+{
+    return EventQueueType::Calendar;
+}
+
+void CalendarEventPriorityQueue::enqueue(Event event)
+{
+    QueuedEvent queuedEvent;
+    queuedEvent.event = event;
+    queuedEvent.sequence = m_nextSequence++;
+
+    qint64 virtualBucket = getVirtualBucket(event.time);
+    if (m_size == 0 || virtualBucket < m_currentVirtualBucket)
+    {
+        m_currentVirtualBucket = virtualBucket;
+    }
+
+    insert(queuedEvent);
+    ++m_size;
+
+    if (m_size > 2 * m_buckets.size())
+    {
+        resize(2 * m_buckets.size());
+    }
+}
+
+Event CalendarEventPriorityQueue::dequeue()
+{
+    Bucket& bucket = m_buckets[findHeadBucket()];
+
+    Event event = bucket.last().event;
+    bucket.removeLast();
+    --m_size;
+
+    if (m_size < m_buckets.size() / 2 && m_buckets.size() > MIN_BUCKET_COUNT)
+    {
+        resize(m_buckets.size() / 2);
+    }
+
+    return event;
+}
+
+Event CalendarEventPriorityQueue::head()
+{
+    return m_buckets.at(findHeadBucket()).last().event;
+}
+
+bool CalendarEventPriorityQueue::isEmpty() const
+{
+    return m_size == 0;
+}
+
+void CalendarEventPriorityQueue::clear()
+{
+    m_buckets.clear();
+    m_buckets.resize(MIN_BUCKET_COUNT);
+    m_bucketWidth = INITIAL_BUCKET_WIDTH;
+    m_currentVirtualBucket = 0;
+    m_size = 0;
+    m_nextSequence = 0;
+}
+
+QList<Event> CalendarEventPriorityQueue::getAll() const
+{
+    QVector<QueuedEvent> sortedEvents;
+    for (const Bucket& bucket : m_buckets)
+    {
+        sortedEvents += bucket;
+    }
+    std::sort(sortedEvents.begin(), sortedEvents.end(), &EventPriorityQueue::isBefore);
+
+    QList<Event> events;
+    for (const QueuedEvent& queuedEvent : sortedEvents)
+    {
+        events.append(queuedEvent.event);
+    }
+    return events;
+}
+
+qint64 CalendarEventPriorityQueue::getVirtualBucket(double time) const
+{
+    return static_cast<qint64>(std::floor(time / m_bucketWidth));
+}
+
+int CalendarEventPriorityQueue::getBucketIndex(qint64 virtualBucket) const
+{
+    int index = static_cast<int>(virtualBucket % m_buckets.size());
+    if (index < 0)
+    {
+        index += m_buckets.size();
+    }
+    return index;
+}
+
+void CalendarEventPriorityQueue::insert(const QueuedEvent& queuedEvent)
+{
+    Bucket& bucket = m_buckets[getBucketIndex(getVirtualBucket(queuedEvent.event.time))];
+
+    auto isAfter = [](const QueuedEvent& a, const QueuedEvent& b) -> bool
+    {
+        return isBefore(b, a);
+    };
+
+    auto it = std::upper_bound(bucket.begin(), bucket.end(), queuedEvent, isAfter);
+    bucket.insert(it, queuedEvent);
+}
+
+// Scans one "year" of buckets starting from the current one. Every event
+// belongs to a virtual bucket not earlier than the current one, so the first
+// bucket whose earliest event falls into the scanned virtual bucket holds the
+// minimum. If a whole year is empty, falls back to a direct search.
+int CalendarEventPriorityQueue::findHeadBucket()
+{
+    for (int i = 0; i < m_buckets.size(); ++i)
+    {
+        int index = getBucketIndex(m_currentVirtualBucket);
+        const Bucket& bucket = m_buckets.at(index);
+
+        if (!bucket.isEmpty() && getVirtualBucket(bucket.last().event.time) == m_currentVirtualBucket)
+        {
+            return index;
+        }
+
+        ++m_currentVirtualBucket;
+    }
+
+    int headIndex = -1;
+    for (int index = 0; index < m_buckets.size(); ++index)
+    {
+        const Bucket& bucket = m_buckets.at(index);
+        if (bucket.isEmpty())
+        {
+            continue;
+        }
+
+        if (headIndex < 0 || isBefore(bucket.last(), m_buckets.at(headIndex).last()))
+        {
+            headIndex = index;
+        }
+    }
+
+    m_currentVirtualBucket = getVirtualBucket(m_buckets.at(headIndex).last().event.time);
+    return headIndex;
+}
+
+void CalendarEventPriorityQueue::resize(int bucketCount)
+{
+    QVector<QueuedEvent> events;
+    events.reserve(m_size);
+    for (const Bucket& bucket : m_buckets)
+    {
+        events += bucket;
+    }
+
+    m_bucketWidth = estimateBucketWidth(events);
+
+    m_buckets.clear();
+    m_buckets.resize(std::max(bucketCount, MIN_BUCKET_COUNT));
+
+    for (const QueuedEvent& queuedEvent : events)
+    {
+        insert(queuedEvent);
+    }
+
+    if (!events.isEmpty())
+    {
+        m_currentVirtualBucket = getVirtualBucket(events.first().event.time);
+    }
+}
+
+// Brown's heuristic: average separation of the earliest events, ignoring
+// separations larger than twice the average, times three. Also moves the
+// earliest event to the front of the vector.
+double CalendarEventPriorityQueue::estimateBucketWidth(QVector<QueuedEvent>& events) const
+{
+    int sampleSize = std::min(events.size(), WIDTH_SAMPLE_SIZE);
+    if (sampleSize < 2)
+    {
+        return m_bucketWidth;
+    }
+
+    std::partial_sort(events.begin(), events.begin() + sampleSize, events.end(), &EventPriorityQueue::isBefore);
+
+    double totalSeparation = events.at(sampleSize - 1).event.time - events.at(0).event.time;
+    double averageSeparation = totalSeparation / (sampleSize - 1);
+
+    double limitedSeparation = 0.0;
+    int limitedCount = 0;
+    for (int i = 1; i < sampleSize; ++i)
+    {
+        double separation = events.at(i).event.time - events.at(i - 1).event.time;
+        if (separation <= 2.0 * averageSeparation)
+        {
+            limitedSeparation += separation;
+            ++limitedCount;
+        }
+    }
+
+    if (limitedCount == 0 || limitedSeparation <= 0.0)
+    {
+        return m_bucketWidth;
+    }
+
+    return 3.0 * limitedSeparation / limitedCount;
+}
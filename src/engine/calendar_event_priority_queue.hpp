@@ -0,0 +1,46 @@
+#pragma once
+
+#include "engine/event_priority_queue.hpp"
+
+#include <QVector>
+
+
+// Calendar queue (R. Brown, 1988). Events are hashed into buckets covering
+// time intervals of equal width; the number of buckets follows the queue size
+// and the width is re-estimated from the event spacing on every resize.
+// Each bucket is kept sorted in descending (time, sequence) order, so the
+// earliest event of a bucket is always at its back.
+class CalendarEventPriorityQueue : public EventPriorityQueue
+{
+public:
+    CalendarEventPriorityQueue();
+
+    virtual EventQueueType getType() const override;
+
+    virtual void enqueue(Event event) override;
+    virtual Event dequeue() override;
+    virtual Event head() override;
+
+    virtual bool isEmpty() const override;
+    virtual void clear() override;
+
+    virtual QList<Event> getAll() const override;
+
+private:
+    typedef QVector<QueuedEvent> Bucket;
+
+    qint64 getVirtualBucket(double time) const;
+    int getBucketIndex(qint64 virtualBucket) const;
+
+    void insert(const QueuedEvent& queuedEvent);
+    int findHeadBucket();
+    void resize(int bucketCount);
+    double estimateBucketWidth(QVector<QueuedEvent>& events) const;
+
+private:
+    QVector<Bucket> m_buckets;
+    double m_bucketWidth;
+    qint64 m_currentVirtualBucket;
+    int m_size;
+    quint64 m_nextSequence;
+};
@@ -0,0 +1,114 @@
+#include "engine/connection_graph.hpp"
+
+
+void ConnectionGraph::build(const QList<Connection>& connections, const QVector<int>& stationIndices, int stationCount)
+{
+    m_outgoingOffsets.fill(0, stationCount + 1);
+    m_incomingOffsets.fill(0, stationCount + 1);
+
+    for (const Connection& connection : connections)
+    {
+        int fromIndex = getStationIndex(stationIndices, connection.from);
+        int toIndex = getStationIndex(stationIndices, connection.to);
+        if (fromIndex < 0 || toIndex < 0)
+        {
+            continue;
+        }
+
+        ++m_outgoingOffsets[fromIndex + 1];
+        ++m_incomingOffsets[toIndex + 1];
+    }
+
+    for (int i = 0; i < stationCount; ++i)
+    {
+        m_outgoingOffsets[i + 1] += m_outgoingOffsets.at(i);
+        m_incomingOffsets[i + 1] += m_incomingOffsets.at(i);
+    }
+
+    m_outgoing.resize(m_outgoingOffsets.last());
+    m_incoming.resize(m_incomingOffsets.last());
+    m_incomingSources.resize(m_incomingOffsets.last());
+
+    QVector<int> outgoingPositions = m_outgoingOffsets;
+    QVector<int> incomingPositions = m_incomingOffsets;
+
+    for (const Connection& connection : connections)
+    {
+        int fromIndex = getStationIndex(stationIndices, connection.from);
+        int toIndex = getStationIndex(stationIndices, connection.to);
+        if (fromIndex < 0 || toIndex < 0)
+        {
+            continue;
+        }
+
+        IncomingSource source;
+        source.stationIndex = fromIndex;
+        source.position = outgoingPositions.at(fromIndex) - m_outgoingOffsets.at(fromIndex);
+
+        m_incomingSources[incomingPositions.at(toIndex)] = source;
+        m_incoming[incomingPositions[toIndex]++] = connection;
+        m_outgoing[outgoingPositions[fromIndex]++] = connection;
+    }
+}
+
+void ConnectionGraph::changeWeight(int fromIndex, int toIndex, int from, int to, int weight)
+{
+    changeWeight(m_outgoing, m_outgoingOffsets, fromIndex, from, to, weight);
+    changeWeight(m_incoming, m_incomingOffsets, toIndex, from, to, weight);
+}
+
+ConnectionGraph::Range ConnectionGraph::getOutgoing(int stationIndex) const
+{
+    if (stationIndex < 0 || stationIndex + 1 >= m_outgoingOffsets.size())
+    {
+        return Range(nullptr, nullptr);
+    }
+
+    const Connection* connections = m_outgoing.constData();
+    return Range(connections + m_outgoingOffsets.at(stationIndex), connections + m_outgoingOffsets.at(stationIndex + 1));
+}
+
+ConnectionGraph::Range ConnectionGraph::getIncoming(int stationIndex) const
+{
+    if (stationIndex < 0 || stationIndex + 1 >= m_incomingOffsets.size())
+    {
+        return Range(nullptr, nullptr);
+    }
+
+    const Connection* connections = m_incoming.constData();
+    return Range(connections + m_incomingOffsets.at(stationIndex), connections + m_incomingOffsets.at(stationIndex + 1));
+}
+
+ConnectionGraph::IncomingSource ConnectionGraph::getIncomingSource(int stationIndex, int i) const
+{
+    return m_incomingSources.at(m_incomingOffsets.at(stationIndex) + i);
+}
+
+int ConnectionGraph::getStationIndex(const QVector<int>& stationIndices, int stationId)
+{
+    int key = stationId - OUTPUT_STATION_ID;
+    if (key < 0 || key >= stationIndices.size())
+    {
+        return -1;
+    }
+
+    return stationIndices.at(key);
+}
+
+void ConnectionGraph::changeWeight(QVector<Connection>& connections, const QVector<int>& offsets, int stationIndex,
+                                   int from, int to, int weight)
+{
+    if (stationIndex < 0 || stationIndex + 1 >= offsets.size())
+    {
+        return;
+    }
+
+    for (int i = offsets.at(stationIndex); i < offsets.at(stationIndex + 1); ++i)
+    {
+        Connection& connection = connections[i];
+        if (connection.from == from && connection.to == to)
+        {
+            connection.weight = weight;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "engine/connection.hpp"
+
+#include <QList>
+#include <QVector>
+
+
+// Compressed sparse row adjacency of a network, holding the outgoing and
+// incoming connections of every station in contiguous arrays. Stations are
+// addressed by their index in the working instance, so iterating over
+// connections of a station needs no lookup and no allocation.
+class ConnectionGraph
+{
+public:
+    class Range
+    {
+    public:
+        Range(const Connection* first, const Connection* last)
+         : m_first(first)
+         , m_last(last)
+        {}
+
+        const Connection* begin() const { return m_first; }
+        const Connection* end() const { return m_last; }
+
+        int size() const { return static_cast<int>(m_last - m_first); }
+        bool isEmpty() const { return m_first == m_last; }
+        const Connection& at(int i) const { return m_first[i]; }
+
+    private:
+        const Connection* m_first;
+        const Connection* m_last;
+    };
+
+    // Where the i-th incoming connection of a station comes from: index of the
+    // source station and position of the connection in its outgoing range
+    struct IncomingSource
+    {
+        int stationIndex;
+        int position;
+    };
+
+public:
+    // stationIndices maps station ids shifted by OUTPUT_STATION_ID to
+    // station indices; connections with unknown stations are skipped
+    void build(const QList<Connection>& connections, const QVector<int>& stationIndices, int stationCount);
+    void changeWeight(int fromIndex, int toIndex, int from, int to, int weight);
+
+    Range getOutgoing(int stationIndex) const;
+    Range getIncoming(int stationIndex) const;
+    IncomingSource getIncomingSource(int stationIndex, int i) const;
+
+private:
+    static int getStationIndex(const QVector<int>& stationIndices, int stationId);
+    static void changeWeight(QVector<Connection>& connections, const QVector<int>& offsets, int stationIndex,
+                             int from, int to, int weight);
+
+private:
+    QVector<int> m_outgoingOffsets;
+    QVector<Connection> m_outgoing;
+    QVector<int> m_incomingOffsets;
+    QVector<Connection> m_incoming;
+    QVector<IncomingSource> m_incomingSources;
+};
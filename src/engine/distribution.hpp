@@ -1,17 +1,38 @@
 #pragma once
 
+#include <QSharedPointer>
+#include <QVector>
+
+class EmpiricalTable;
+class TraceFile;
+
+// Parameters of each type, the ones after a semicolon are kept in params
 enum class DistributionType
 {
-    Constant,
-    Uniform,
-    Normal,
-    Exponential
+    Constant,                   // value
+    Uniform,                    // min, max
+    Normal,                     // mean, standard deviation
+    Exponential,                // mean
+    Lognormal,                  // mean, standard deviation of the logarithm
+    Gamma,                      // shape, scale
+    Erlang,                     // number of phases, mean of a phase
+    Weibull,                    // shape, scale
+    HyperExponential,           // pairs of branch probability and mean
+    PhaseType,                  // phases; initial probabilities, sub-generator rows
+    MarkovModulatedPoisson,     // phases; phase arrival rates, phase change generator rows
+    MarkovianArrival,           // phases; rows of D0, then rows of D1
+    NonHomogeneousPoisson,      // linear if not zero; periodic schedule of time and rate pairs
+    Empirical,                  // shared table
+    Trace                       // loops if not zero; shared trace
 };
 
 struct Distribution
 {
     DistributionType type;
     double param1, param2;
+    QVector<double> params;
+    QSharedPointer<const EmpiricalTable> table;
+    QSharedPointer<const TraceFile> trace;
 
     Distribution()
      : type(DistributionType::Exponential)
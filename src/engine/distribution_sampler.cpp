@@ -0,0 +1,1075 @@
+#include "engine/distribution_sampler.hpp"
+
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/math/special_functions/gamma.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Ziggurat tables of Marsaglia and Tsang with 256 layers for the
+    // exponential and 128 layers for the half-normal density
+    const int EXPONENTIAL_LAYER_COUNT = 256;
+    const int NORMAL_LAYER_COUNT = 128;
+    const int NORMAL_SIGN_BIT = 7;
+    const double EXPONENTIAL_R = 7.69711747013104972;
+    const double EXPONENTIAL_V = 3.949659822581572e-3;
+    const double NORMAL_R = 3.442619855899;
+    const double NORMAL_V = 9.91256303526217e-3;
+
+    struct ZigguratTables
+    {
+        quint32 exponentialK[EXPONENTIAL_LAYER_COUNT];
+        double exponentialW[EXPONENTIAL_LAYER_COUNT];
+        double exponentialF[EXPONENTIAL_LAYER_COUNT];
+        quint32 normalK[NORMAL_LAYER_COUNT];
+        double normalW[NORMAL_LAYER_COUNT];
+        double normalF[NORMAL_LAYER_COUNT];
+
+        ZigguratTables()
+        {
+            const double m1 = 2147483648.0;
+            const double m2 = 4294967296.0;
+
+            double de = EXPONENTIAL_R;
+            double te = de;
+            double qe = EXPONENTIAL_V / std::exp(-de);
+            exponentialK[0] = static_cast<quint32>((de / qe) * m2);
+            exponentialK[1] = 0;
+            exponentialW[0] = qe / m2;
+            exponentialW[EXPONENTIAL_LAYER_COUNT - 1] = de / m2;
+            exponentialF[0] = 1.0;
+            exponentialF[EXPONENTIAL_LAYER_COUNT - 1] = std::exp(-de);
+            for (int i = EXPONENTIAL_LAYER_COUNT - 2; i >= 1; --i)
+            {
+                de = -std::log(EXPONENTIAL_V / de + std::exp(-de));
+                exponentialK[i + 1] = static_cast<quint32>((de / te) * m2);
+                te = de;
+                exponentialF[i] = std::exp(-de);
+                exponentialW[i] = de / m2;
+            }
+
+            double dn = NORMAL_R;
+            double tn = dn;
+            double qn = NORMAL_V / std::exp(-0.5 * dn * dn);
+            normalK[0] = static_cast<quint32>((dn / qn) * m1);
+            normalK[1] = 0;
+            normalW[0] = qn / m1;
+            normalW[NORMAL_LAYER_COUNT - 1] = dn / m1;
+            normalF[0] = 1.0;
+            normalF[NORMAL_LAYER_COUNT - 1] = std::exp(-0.5 * dn * dn);
+            for (int i = NORMAL_LAYER_COUNT - 2; i >= 1; --i)
+            {
+                dn = std::sqrt(-2.0 * std::log(NORMAL_V / dn + std::exp(-0.5 * dn * dn)));
+                normalK[i + 1] = static_cast<quint32>((dn / tn) * m1);
+                tn = dn;
+                normalF[i] = std::exp(-0.5 * dn * dn);
+                normalW[i] = dn / m1;
+            }
+        }
+    };
+
+    const ZigguratTables& getZigguratTables()
+    {
+        static const ZigguratTables tables;
+        return tables;
+    }
+
+    // The low bits of a 64-bit draw select the layer, the high ones give
+    // the value, so the two are not correlated
+
+    double sampleExponentialSlow(RandomStream& stream, quint64 bits, const ZigguratTables& tables)
+    {
+        while (true)
+        {
+            int layer = bits & (EXPONENTIAL_LAYER_COUNT - 1);
+            quint32 value = bits >> 32;
+
+            if (value < tables.exponentialK[layer])
+            {
+                return value * tables.exponentialW[layer];
+            }
+
+            if (layer == 0)
+            {
+                return EXPONENTIAL_R - std::log(stream.nextDouble());
+            }
+
+            double x = value * tables.exponentialW[layer];
+            double f = tables.exponentialF[layer];
+            if (f + stream.nextDouble() * (tables.exponentialF[layer - 1] - f) < std::exp(-x))
+            {
+                return x;
+            }
+
+            bits = stream.next64();
+        }
+    }
+
+    double sampleNormalSlow(RandomStream& stream, quint64 bits, const ZigguratTables& tables)
+    {
+        while (true)
+        {
+            int layer = bits & (NORMAL_LAYER_COUNT - 1);
+            double sign = 1.0 - 2.0 * ((bits >> NORMAL_SIGN_BIT) & 1);
+            quint32 value = bits >> 33;
+
+            if (value < tables.normalK[layer])
+            {
+                return sign * (value * tables.normalW[layer]);
+            }
+
+            if (layer == 0)
+            {
+                double x, y;
+                do
+                {
+                    x = -std::log(stream.nextDouble()) / NORMAL_R;
+                    y = -std::log(stream.nextDouble());
+                }
+                while (y + y < x * x);
+
+                return sign * (NORMAL_R + x);
+            }
+
+            double x = value * tables.normalW[layer];
+            double f = tables.normalF[layer];
+            if (f + stream.nextDouble() * (tables.normalF[layer - 1] - f) < std::exp(-0.5 * x * x))
+            {
+                return sign * x;
+            }
+
+            bits = stream.next64();
+        }
+    }
+
+    // The common case of a draw falling inside its layer is computed for the
+    // whole block without branches, so that the compiler can vectorize it,
+    // the rare rejected draws are fixed up afterwards
+    void fillExponential(RandomStream& stream, double* values, int count)
+    {
+        const ZigguratTables& tables = getZigguratTables();
+
+        quint64 bits[DistributionSampler::BLOCK_SIZE];
+        bool accepted[DistributionSampler::BLOCK_SIZE];
+        stream.fill(bits, count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            int layer = bits[i] & (EXPONENTIAL_LAYER_COUNT - 1);
+            quint32 value = bits[i] >> 32;
+            values[i] = value * tables.exponentialW[layer];
+            accepted[i] = value < tables.exponentialK[layer];
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (!accepted[i])
+            {
+                values[i] = sampleExponentialSlow(stream, bits[i], tables);
+            }
+        }
+    }
+
+    void fillNormal(RandomStream& stream, double* values, int count)
+    {
+        const ZigguratTables& tables = getZigguratTables();
+
+        quint64 bits[DistributionSampler::BLOCK_SIZE];
+        bool accepted[DistributionSampler::BLOCK_SIZE];
+        stream.fill(bits, count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            int layer = bits[i] & (NORMAL_LAYER_COUNT - 1);
+            double sign = 1.0 - 2.0 * ((bits[i] >> NORMAL_SIGN_BIT) & 1);
+            quint32 value = bits[i] >> 33;
+            values[i] = sign * (value * tables.normalW[layer]);
+            accepted[i] = value < tables.normalK[layer];
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (!accepted[i])
+            {
+                values[i] = sampleNormalSlow(stream, bits[i], tables);
+            }
+        }
+    }
+
+    void fillExponentialInverse(RandomStream& stream, double* values, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = -std::log(stream.nextDouble());
+        }
+    }
+
+    void fillNormalInverse(RandomStream& stream, double* values, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = -M_SQRT2 * boost::math::erfc_inv(2.0 * stream.nextDouble());
+        }
+    }
+
+    void fillUniform(RandomStream& stream, double* values, int count)
+    {
+        quint64 bits[DistributionSampler::BLOCK_SIZE];
+        stream.fill(bits, count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = RandomStream::toDouble(bits[i]);
+        }
+    }
+
+    // Marsaglia and Tsang, shapes below one are boosted by one and scaled
+    // back with a power of a uniform
+    double sampleGamma(RandomStream& stream, double shape, const ZigguratTables& tables)
+    {
+        if (shape < 1.0)
+        {
+            double boost = std::pow(stream.nextDouble(), 1.0 / shape);
+            return sampleGamma(stream, shape + 1.0, tables) * boost;
+        }
+
+        double d = shape - 1.0 / 3.0;
+        double c = 1.0 / std::sqrt(9.0 * d);
+        while (true)
+        {
+            double x = sampleNormalSlow(stream, stream.next64(), tables);
+            double v = 1.0 + c * x;
+            if (v <= 0.0)
+            {
+                continue;
+            }
+
+            v = v * v * v;
+            double u = stream.nextDouble();
+            if (u < 1.0 - 0.0331 * x * x * x * x || std::log(u) < 0.5 * x * x + d * (1.0 - v + std::log(v)))
+            {
+                return d * v;
+            }
+        }
+    }
+
+    void fillGamma(RandomStream& stream, double shape, double* values, int count)
+    {
+        const ZigguratTables& tables = getZigguratTables();
+
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = sampleGamma(stream, shape, tables);
+        }
+    }
+
+    void fillGammaInverse(RandomStream& stream, double shape, double* values, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = boost::math::gamma_p_inv(shape, stream.nextDouble());
+        }
+    }
+
+    // Number of phases of a distribution given by the number of phases in
+    // param1 and as many vectors and square matrices of that size in params
+    // as passed, -1 if the parameters do not fit
+    int getPhaseCount(const Distribution& distribution, int vectorCount, int matrixCount)
+    {
+        int phaseCount = static_cast<int>(distribution.param1);
+        if (phaseCount < 1 || phaseCount != distribution.param1
+            || distribution.params.size() != vectorCount * phaseCount + matrixCount * phaseCount * phaseCount)
+        {
+            return -1;
+        }
+
+        return phaseCount;
+    }
+
+    // Rows of D0 and D1 of a Markovian arrival process, a Markov-modulated
+    // Poisson process being one with the arrival rates on the diagonal of D1.
+    // Returns the number of phases, -1 if the parameters do not fit.
+    int getArrivalMatrices(const Distribution& distribution, QVector<double>& hidden, QVector<double>& arrival)
+    {
+        if (distribution.type == DistributionType::MarkovianArrival)
+        {
+            int phaseCount = getPhaseCount(distribution, 0, 2);
+            if (phaseCount < 0)
+            {
+                return -1;
+            }
+
+            hidden = distribution.params.mid(0, phaseCount * phaseCount);
+            arrival = distribution.params.mid(phaseCount * phaseCount);
+            return phaseCount;
+        }
+
+        int phaseCount = getPhaseCount(distribution, 1, 1);
+        if (phaseCount < 0)
+        {
+            return -1;
+        }
+
+        hidden = distribution.params.mid(phaseCount);
+        arrival.fill(0.0, phaseCount * phaseCount);
+        for (int i = 0; i < phaseCount; ++i)
+        {
+            double rate = distribution.params.at(i);
+            arrival[i * phaseCount + i] = rate;
+            hidden[i * phaseCount + i] -= rate;
+        }
+        return phaseCount;
+    }
+
+    // Solves pi (D0 + D1) = 0 with the probabilities summing to one by
+    // Gaussian elimination, empty if there is no unique solution
+    QVector<double> getStationaryDistribution(const QVector<double>& hidden, const QVector<double>& arrival,
+                                              int phaseCount)
+    {
+        const int n = phaseCount;
+        const int width = n + 1;
+
+        // The transposed system with the last equation replaced by the sum
+        QVector<double> system(n * width);
+        double scale = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                double value = i == n - 1 ? 1.0 : hidden.at(j * n + i) + arrival.at(j * n + i);
+                system[i * width + j] = value;
+                scale = std::max(scale, std::fabs(value));
+            }
+            system[i * width + n] = i == n - 1 ? 1.0 : 0.0;
+        }
+
+        for (int column = 0; column < n; ++column)
+        {
+            int pivot = column;
+            for (int row = column + 1; row < n; ++row)
+            {
+                if (std::fabs(system.at(row * width + column)) > std::fabs(system.at(pivot * width + column)))
+                {
+                    pivot = row;
+                }
+            }
+
+            if (std::fabs(system.at(pivot * width + column)) <= 1e-12 * scale)
+            {
+                return QVector<double>();
+            }
+
+            for (int j = 0; j < width; ++j)
+            {
+                std::swap(system[column * width + j], system[pivot * width + j]);
+            }
+
+            for (int row = column + 1; row < n; ++row)
+            {
+                double factor = system.at(row * width + column) / system.at(column * width + column);
+                for (int j = column; j < width; ++j)
+                {
+                    system[row * width + j] -= factor * system.at(column * width + j);
+                }
+            }
+        }
+
+        QVector<double> stationary(n);
+        for (int i = n - 1; i >= 0; --i)
+        {
+            double value = system.at(i * width + n);
+            for (int j = i + 1; j < n; ++j)
+            {
+                value -= system.at(i * width + j) * stationary.at(j);
+            }
+            stationary[i] = std::max(value / system.at(i * width + i), 0.0);
+        }
+
+        return stationary;
+    }
+}
+
+
+const int DistributionSampler::BLOCK_SIZE;
+const int DistributionSampler::TRACE_CHUNK_SIZE;
+
+DistributionSampler::DistributionSampler()
+ : DistributionSampler(Distribution())
+{}
+
+DistributionSampler::DistributionSampler(const Distribution& distribution, SamplingMethod method)
+ : m_type(distribution.type)
+ , m_method(method)
+ , m_offset(0.0)
+ , m_scale(1.0)
+ , m_shape(1.0)
+ , m_phase(-1)
+ , m_segment(0)
+ , m_periodStart(0.0)
+ , m_time(0.0)
+ , m_traceValues(nullptr)
+ , m_loop(false)
+ , m_exhausted(false)
+ , m_traceOffset(0)
+ , m_buffer(BLOCK_SIZE)
+ , m_count(0)
+ , m_position(0)
+{
+    if (!isValid(distribution))
+    {
+        m_type = DistributionType::Constant;
+        m_scale = 0.0;
+        return;
+    }
+
+    switch (distribution.type)
+    {
+        case DistributionType::Constant:
+            m_offset = distribution.param1;
+            m_scale = 0.0;
+            break;
+
+        case DistributionType::Uniform:
+            m_offset = distribution.param1;
+            m_scale = distribution.param2 - distribution.param1;
+            break;
+
+        case DistributionType::Normal:
+        case DistributionType::Lognormal:
+            m_offset = distribution.param1;
+            m_scale = distribution.param2;
+            break;
+
+        case DistributionType::Exponential:
+            m_scale = distribution.param1;
+            break;
+
+        case DistributionType::Gamma:
+        case DistributionType::Erlang:
+        case DistributionType::Weibull:
+            m_shape = distribution.param1;
+            m_scale = distribution.param2;
+            break;
+
+        case DistributionType::HyperExponential:
+        {
+            for (int i = 0; i < distribution.params.size(); i += 2)
+            {
+                m_branchProbabilities.append(distribution.params.at(i));
+                m_branchMeans.append(distribution.params.at(i + 1));
+            }
+            m_branchTable = AliasTable(m_branchProbabilities);
+            break;
+        }
+
+        case DistributionType::PhaseType:
+        {
+            int phaseCount = getPhaseCount(distribution, 1, 1);
+            const double* initialProbabilities = distribution.params.constData();
+            const double* generator = initialProbabilities + phaseCount;
+
+            QVector<double> weights;
+            double absorbedWeight = 1.0;
+            for (int i = 0; i < phaseCount; ++i)
+            {
+                weights.append(initialProbabilities[i]);
+                absorbedWeight -= initialProbabilities[i];
+            }
+            weights.append(std::max(absorbedWeight, 0.0));
+            m_initialPhaseTable = AliasTable(weights);
+
+            for (int i = 0; i < phaseCount; ++i)
+            {
+                const double* row = generator + i * phaseCount;
+                double rate = -row[i];
+
+                weights.clear();
+                absorbedWeight = rate;
+                for (int j = 0; j < phaseCount; ++j)
+                {
+                    weights.append(j == i ? 0.0 : row[j]);
+                    absorbedWeight -= weights.last();
+                }
+                weights.append(std::max(absorbedWeight, 0.0));
+
+                m_phaseRates.append(rate);
+                m_phaseTables.append(AliasTable(weights));
+            }
+            break;
+        }
+
+        case DistributionType::MarkovModulatedPoisson:
+        case DistributionType::MarkovianArrival:
+        {
+            QVector<double> hidden;
+            QVector<double> arrival;
+            int phaseCount = getArrivalMatrices(distribution, hidden, arrival);
+            m_initialPhaseTable = AliasTable(getStationaryDistribution(hidden, arrival, phaseCount));
+
+            for (int i = 0; i < phaseCount; ++i)
+            {
+                QVector<double> weights;
+                for (int j = 0; j < phaseCount; ++j)
+                {
+                    weights.append(j == i ? 0.0 : hidden.at(i * phaseCount + j));
+                }
+                for (int j = 0; j < phaseCount; ++j)
+                {
+                    weights.append(arrival.at(i * phaseCount + j));
+                }
+
+                m_phaseRates.append(-hidden.at(i * phaseCount + i));
+                m_phaseTables.append(AliasTable(weights));
+            }
+            break;
+        }
+
+        case DistributionType::NonHomogeneousPoisson:
+        {
+            bool linear = distribution.param1 != 0.0;
+            for (int i = 0; i < distribution.params.size(); i += 2)
+            {
+                m_rateTimes.append(distribution.params.at(i));
+                m_rates.append(distribution.params.at(i + 1));
+            }
+
+            for (int i = 0; i + 1 < m_rateTimes.size(); ++i)
+            {
+                double slope = linear ? (m_rates.at(i + 1) - m_rates.at(i)) / (m_rateTimes.at(i + 1) - m_rateTimes.at(i))
+                                      : 0.0;
+                m_rateSlopes.append(slope);
+                m_majorantRates.append(linear ? std::max(m_rates.at(i), m_rates.at(i + 1)) : m_rates.at(i));
+            }
+            break;
+        }
+
+        case DistributionType::Empirical:
+            m_table = distribution.table;
+            break;
+
+        case DistributionType::Trace:
+            m_trace = distribution.trace;
+            m_loop = distribution.param1 != 0.0;
+            break;
+    }
+}
+
+bool DistributionSampler::isValid(const Distribution& distribution)
+{
+    switch (distribution.type)
+    {
+        case DistributionType::Constant:
+            return distribution.param1 >= 0.0;
+
+        case DistributionType::Uniform:
+            return distribution.param1 >= 0.0 && distribution.param2 >= distribution.param1;
+
+        case DistributionType::Normal:
+        case DistributionType::Lognormal:
+            return distribution.param2 >= 0.0;
+
+        case DistributionType::Exponential:
+            return distribution.param1 > 0.0;
+
+        case DistributionType::Gamma:
+        case DistributionType::Weibull:
+            return distribution.param1 > 0.0 && distribution.param2 > 0.0;
+
+        case DistributionType::Erlang:
+            return distribution.param1 >= 1.0 && distribution.param1 == std::floor(distribution.param1)
+                   && distribution.param2 > 0.0;
+
+        case DistributionType::HyperExponential:
+        {
+            const QVector<double>& params = distribution.params;
+            if (params.isEmpty() || params.size() % 2 != 0)
+            {
+                return false;
+            }
+
+            double totalProbability = 0.0;
+            for (int i = 0; i < params.size(); i += 2)
+            {
+                if (params.at(i) < 0.0 || params.at(i + 1) <= 0.0)
+                {
+                    return false;
+                }
+                totalProbability += params.at(i);
+            }
+            return std::fabs(totalProbability - 1.0) < 1e-9;
+        }
+
+        case DistributionType::PhaseType:
+        {
+            int phaseCount = getPhaseCount(distribution, 1, 1);
+            if (phaseCount < 0)
+            {
+                return false;
+            }
+
+            const double* initialProbabilities = distribution.params.constData();
+            const double* generator = initialProbabilities + phaseCount;
+
+            double totalProbability = 0.0;
+            for (int i = 0; i < phaseCount; ++i)
+            {
+                if (initialProbabilities[i] < 0.0)
+                {
+                    return false;
+                }
+                totalProbability += initialProbabilities[i];
+
+                // Every phase has to be left at a positive rate and the
+                // rates of leaving it may not exceed that rate
+                const double* row = generator + i * phaseCount;
+                double rowSum = 0.0;
+                for (int j = 0; j < phaseCount; ++j)
+                {
+                    if (j != i && row[j] < 0.0)
+                    {
+                        return false;
+                    }
+                    rowSum += row[j];
+                }
+                if (row[i] >= 0.0 || rowSum > 1e-9 * -row[i])
+                {
+                    return false;
+                }
+            }
+            return totalProbability <= 1.0 + 1e-9;
+        }
+
+        case DistributionType::MarkovModulatedPoisson:
+        case DistributionType::MarkovianArrival:
+        {
+            QVector<double> hidden;
+            QVector<double> arrival;
+            int phaseCount = getArrivalMatrices(distribution, hidden, arrival);
+            if (phaseCount < 0)
+            {
+                return false;
+            }
+
+            // D0 + D1 has to be a generator with every phase left at a
+            // positive rate
+            for (int i = 0; i < phaseCount; ++i)
+            {
+                double rowSum = 0.0;
+                for (int j = 0; j < phaseCount; ++j)
+                {
+                    double hiddenRate = hidden.at(i * phaseCount + j);
+                    double arrivalRate = arrival.at(i * phaseCount + j);
+                    if ((j != i && hiddenRate < 0.0) || arrivalRate < 0.0)
+                    {
+                        return false;
+                    }
+                    rowSum += hiddenRate + arrivalRate;
+                }
+
+                double diagonal = hidden.at(i * phaseCount + i);
+                if (diagonal >= 0.0 || std::fabs(rowSum) > 1e-9 * -diagonal)
+                {
+                    return false;
+                }
+            }
+
+            QVector<double> stationary = getStationaryDistribution(hidden, arrival, phaseCount);
+            if (stationary.isEmpty())
+            {
+                return false;
+            }
+
+            double arrivalRate = 0.0;
+            for (int i = 0; i < phaseCount; ++i)
+            {
+                for (int j = 0; j < phaseCount; ++j)
+                {
+                    arrivalRate += stationary.at(i) * arrival.at(i * phaseCount + j);
+                }
+            }
+            return arrivalRate > 0.0;
+        }
+
+        case DistributionType::NonHomogeneousPoisson:
+        {
+            // Times have to start at zero and increase, the rates may not
+            // all be zero
+            const QVector<double>& params = distribution.params;
+            if (params.size() < 4 || params.size() % 2 != 0 || params.at(0) != 0.0)
+            {
+                return false;
+            }
+
+            bool linear = distribution.param1 != 0.0;
+            bool hasArrivals = false;
+            for (int i = 0; i < params.size(); i += 2)
+            {
+                if (!std::isfinite(params.at(i)) || (i > 0 && params.at(i) <= params.at(i - 2))
+                    || !std::isfinite(params.at(i + 1)) || params.at(i + 1) < 0.0)
+                {
+                    return false;
+                }
+
+                if (params.at(i + 1) > 0.0 && (linear || i + 2 < params.size()))
+                {
+                    hasArrivals = true;
+                }
+            }
+            return hasArrivals;
+        }
+
+        case DistributionType::Empirical:
+            return !distribution.table.isNull();
+
+        case DistributionType::Trace:
+            return !distribution.trace.isNull() && distribution.trace->size() > 0;
+    }
+
+    return false;
+}
+
+bool DistributionSampler::isArrivalProcess(DistributionType type)
+{
+    return type == DistributionType::MarkovModulatedPoisson || type == DistributionType::MarkovianArrival
+        || type == DistributionType::NonHomogeneousPoisson;
+}
+
+void DistributionSampler::reset()
+{
+    m_phase = -1;
+    m_segment = 0;
+    m_periodStart = 0.0;
+    m_time = 0.0;
+    m_exhausted = false;
+    m_traceOffset = 0;
+    m_traceValues = nullptr;
+    m_count = 0;
+    m_position = 0;
+}
+
+bool DistributionSampler::isExhausted() const
+{
+    return m_exhausted;
+}
+
+void DistributionSampler::refill(RandomStream& stream)
+{
+    if (m_type == DistributionType::Trace)
+    {
+        refillTrace();
+        return;
+    }
+
+    double* values = m_buffer.data();
+    m_count = BLOCK_SIZE;
+    bool inverse = m_method == SamplingMethod::InverseTransform;
+
+    switch (m_type)
+    {
+        case DistributionType::Constant:
+            m_buffer.fill(m_offset);
+            break;
+
+        case DistributionType::Uniform:
+            fillUniform(stream, values, BLOCK_SIZE);
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                values[i] = m_offset + m_scale * values[i];
+            }
+            break;
+
+        case DistributionType::Normal:
+        case DistributionType::Lognormal:
+            if (inverse)
+            {
+                fillNormalInverse(stream, values, BLOCK_SIZE);
+            }
+            else
+            {
+                fillNormal(stream, values, BLOCK_SIZE);
+            }
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                values[i] = m_offset + m_scale * values[i];
+            }
+
+            if (m_type == DistributionType::Lognormal)
+            {
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                {
+                    values[i] = std::exp(values[i]);
+                }
+            }
+            break;
+
+        case DistributionType::Exponential:
+        case DistributionType::Weibull:
+            if (inverse)
+            {
+                fillExponentialInverse(stream, values, BLOCK_SIZE);
+            }
+            else
+            {
+                fillExponential(stream, values, BLOCK_SIZE);
+            }
+
+            if (m_type == DistributionType::Weibull)
+            {
+                for (int i = 0; i < BLOCK_SIZE; ++i)
+                {
+                    values[i] = std::pow(values[i], 1.0 / m_shape);
+                }
+            }
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                values[i] = m_scale * values[i];
+            }
+            break;
+
+        case DistributionType::Gamma:
+        case DistributionType::Erlang:
+            if (inverse)
+            {
+                fillGammaInverse(stream, m_shape, values, BLOCK_SIZE);
+            }
+            else
+            {
+                fillGamma(stream, m_shape, values, BLOCK_SIZE);
+            }
+
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                values[i] = m_scale * values[i];
+            }
+            break;
+
+        case DistributionType::HyperExponential:
+            fillHyperExponential(stream, values, BLOCK_SIZE);
+            break;
+
+        case DistributionType::PhaseType:
+            fillPhaseType(stream, values, BLOCK_SIZE);
+            break;
+
+        case DistributionType::MarkovModulatedPoisson:
+        case DistributionType::MarkovianArrival:
+            fillMarkovianArrival(stream, values, BLOCK_SIZE);
+            break;
+
+        case DistributionType::NonHomogeneousPoisson:
+            fillNonHomogeneousPoisson(stream, values, BLOCK_SIZE);
+            break;
+
+        case DistributionType::Empirical:
+            fillUniform(stream, values, BLOCK_SIZE);
+            for (int i = 0; i < BLOCK_SIZE; ++i)
+            {
+                values[i] = m_table->getQuantile(values[i]);
+            }
+            break;
+
+        case DistributionType::Trace:
+            break;
+    }
+
+    m_position = 0;
+}
+
+void DistributionSampler::refillTrace()
+{
+    if (m_traceOffset == m_trace->size())
+    {
+        if (m_loop)
+        {
+            m_traceOffset = 0;
+        }
+        else
+        {
+            m_exhausted = true;
+            m_buffer.fill(0.0);
+            m_traceValues = nullptr;
+            m_count = BLOCK_SIZE;
+            m_position = 0;
+            return;
+        }
+    }
+
+    // Little-endian hosts read the mapping in place, others convert a block
+    // at a time into the buffer
+    quint64 remaining = m_trace->size() - m_traceOffset;
+    const double* mapped = m_trace->getValues();
+    if (mapped != nullptr)
+    {
+        m_count = static_cast<int>(qMin<quint64>(remaining, TRACE_CHUNK_SIZE));
+        m_traceValues = mapped + m_traceOffset;
+    }
+    else
+    {
+        m_count = static_cast<int>(qMin<quint64>(remaining, BLOCK_SIZE));
+        for (int i = 0; i < m_count; ++i)
+        {
+            m_buffer[i] = m_trace->getValue(m_traceOffset + i);
+        }
+        m_traceValues = nullptr;
+    }
+
+    m_traceOffset += m_count;
+    m_position = 0;
+}
+
+void DistributionSampler::fillHyperExponential(RandomStream& stream, double* values, int count) const
+{
+    if (m_method == SamplingMethod::InverseTransform)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = getHyperExponentialQuantile(stream.nextDouble());
+        }
+        return;
+    }
+
+    const ZigguratTables& tables = getZigguratTables();
+    for (int i = 0; i < count; ++i)
+    {
+        int branch = m_branchTable.sample(stream);
+        values[i] = m_branchMeans.at(branch) * sampleExponentialSlow(stream, stream.next64(), tables);
+    }
+}
+
+// Walks the phases until absorption, each phase taking an exponential time
+void DistributionSampler::fillPhaseType(RandomStream& stream, double* values, int count) const
+{
+    const ZigguratTables& tables = getZigguratTables();
+    int phaseCount = m_phaseRates.size();
+
+    for (int i = 0; i < count; ++i)
+    {
+        double time = 0.0;
+        int phase = m_initialPhaseTable.sample(stream);
+        while (phase < phaseCount)
+        {
+            time += sampleExponentialSlow(stream, stream.next64(), tables) / m_phaseRates.at(phase);
+            phase = m_phaseTables.at(phase).sample(stream);
+        }
+        values[i] = time;
+    }
+}
+
+// Walks the phases until a change with an arrival, the phase it leads to is
+// where the next variate starts
+void DistributionSampler::fillMarkovianArrival(RandomStream& stream, double* values, int count)
+{
+    const ZigguratTables& tables = getZigguratTables();
+    int phaseCount = m_phaseRates.size();
+
+    if (m_phase < 0)
+    {
+        m_phase = m_initialPhaseTable.sample(stream);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        double time = 0.0;
+        while (true)
+        {
+            time += sampleExponentialSlow(stream, stream.next64(), tables) / m_phaseRates.at(m_phase);
+
+            int next = m_phaseTables.at(m_phase).sample(stream);
+            if (next >= phaseCount)
+            {
+                m_phase = next - phaseCount;
+                break;
+            }
+            m_phase = next;
+        }
+        values[i] = time;
+    }
+}
+
+// Thinning of Lewis and Shedler with a majorizing rate per segment. A
+// candidate beyond the end of its segment is dropped and drawn again from
+// the end, which the memoryless exponential allows, so segments of low
+// rate do not pay for the peak rate of the schedule. Constant rates accept
+// every candidate.
+void DistributionSampler::fillNonHomogeneousPoisson(RandomStream& stream, double* values, int count)
+{
+    const ZigguratTables& tables = getZigguratTables();
+    int segmentCount = m_majorantRates.size();
+    double period = m_rateTimes.last();
+
+    for (int i = 0; i < count; ++i)
+    {
+        double lastArrival = m_time;
+        while (true)
+        {
+            double segmentStart = m_periodStart + m_rateTimes.at(m_segment);
+            double segmentEnd = m_periodStart + m_rateTimes.at(m_segment + 1);
+            double majorantRate = m_majorantRates.at(m_segment);
+
+            double candidate = segmentEnd;
+            if (majorantRate > 0.0)
+            {
+                candidate = m_time + sampleExponentialSlow(stream, stream.next64(), tables) / majorantRate;
+            }
+
+            if (candidate >= segmentEnd)
+            {
+                m_time = segmentEnd;
+                if (++m_segment == segmentCount)
+                {
+                    m_segment = 0;
+                    m_periodStart += period;
+                }
+                continue;
+            }
+
+            m_time = candidate;
+
+            double rate = m_rates.at(m_segment) + m_rateSlopes.at(m_segment) * (m_time - segmentStart);
+            if (rate >= majorantRate || stream.nextDouble() * majorantRate < rate)
+            {
+                break;
+            }
+        }
+
+        values[i] = m_time - lastArrival;
+    }
+}
+
+// The mixture has no closed form inverse, so it is found by bisection on
+// the survival function, starting from a bound given by the largest mean
+double DistributionSampler::getHyperExponentialQuantile(double probability) const
+{
+    const int ITERATION_COUNT = 64;
+
+    double survival = 1.0 - probability;
+    double maxMean = *std::max_element(m_branchMeans.begin(), m_branchMeans.end());
+
+    double low = 0.0;
+    double high = -maxMean * std::log(survival);
+    for (int iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+    {
+        double middle = (low + high) / 2.0;
+
+        double middleSurvival = 0.0;
+        for (int i = 0; i < m_branchMeans.size(); ++i)
+        {
+            middleSurvival += m_branchProbabilities.at(i) * std::exp(-middle / m_branchMeans.at(i));
+        }
+
+        if (middleSurvival > survival)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return (low + high) / 2.0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "engine/alias_table.hpp"
+#include "engine/distribution.hpp"
+#include "engine/empirical_table.hpp"
+#include "engine/random_stream.hpp"
+#include "engine/trace_file.hpp"
+
+#include <QSharedPointer>
+#include <QVector>
+
+// Inverse transform sampling is slower, but maps every uniform to a variate
+// monotonically, which antithetic variates depend on. Phase-type variates
+// and Markovian arrival processes have no closed form inverse and are
+// always drawn by walking the phases, non-homogeneous Poisson processes by
+// thinning.
+enum class SamplingMethod
+{
+    Ziggurat,
+    InverseTransform
+};
+
+// Draws variates of a distribution whose parameters were turned into the
+// form the sampling needs once, when the sampler was built: an affine
+// transform of a standard variate, alias tables for the branches of a
+// hyper-exponential and the phase transitions of a phase-type distribution
+// or a Markovian arrival process. The phase of an arrival process carries
+// over from one variate to the next, starting from the stationary
+// distribution, so that consecutive variates are correlated. A
+// non-homogeneous Poisson process keeps the time of its last arrival, which
+// the sampler has to be the only source of, and thins candidates drawn at
+// the highest rate of the current segment of the schedule.
+// Standard variates are generated a block at a time, exponential and normal
+// ones with the ziggurat method, gamma ones with the method of Marsaglia and
+// Tsang, and handed out from a buffer. A sampler should be the only user of
+// its stream, otherwise the buffered block would change which numbers the
+// other users get. Traces are handed out straight from their mapping, in
+// chunks, without drawing from the stream; a trace that is not looped
+// leaves the sampler exhausted at its end, giving zeros from then on.
+class DistributionSampler
+{
+public:
+    static const int BLOCK_SIZE = 64;
+    static const int TRACE_CHUNK_SIZE = 1 << 20;
+
+public:
+    DistributionSampler();
+    explicit DistributionSampler(const Distribution& distribution,
+                                 SamplingMethod method = SamplingMethod::Ziggurat);
+
+    static bool isValid(const Distribution& distribution);
+
+    // Processes keeping their phase or time from one variate to the next,
+    // their variates are times between arrivals
+    static bool isArrivalProcess(DistributionType type);
+
+    // Drops the buffered variates, needed after the stream was reseeded,
+    // and rewinds a trace
+    void reset();
+
+    bool isExhausted() const;
+
+    double sample(RandomStream& stream)
+    {
+        if (m_position == m_count)
+        {
+            refill(stream);
+        }
+
+        return m_traceValues != nullptr ? m_traceValues[m_position++] : m_buffer.at(m_position++);
+    }
+
+private:
+    void refill(RandomStream& stream);
+    void refillTrace();
+    void fillHyperExponential(RandomStream& stream, double* values, int count) const;
+    void fillPhaseType(RandomStream& stream, double* values, int count) const;
+    void fillMarkovianArrival(RandomStream& stream, double* values, int count);
+    void fillNonHomogeneousPoisson(RandomStream& stream, double* values, int count);
+    double getHyperExponentialQuantile(double probability) const;
+
+private:
+    DistributionType m_type;
+    SamplingMethod m_method;
+    double m_offset;
+    double m_scale;
+    double m_shape;
+
+    QVector<double> m_branchProbabilities;
+    QVector<double> m_branchMeans;
+    AliasTable m_branchTable;
+
+    // Choices of the next phase, the last item meaning absorption. For an
+    // arrival process the first half are changes without an arrival, the
+    // second half changes with one.
+    AliasTable m_initialPhaseTable;
+    QVector<AliasTable> m_phaseTables;
+    QVector<double> m_phaseRates;
+    int m_phase;
+
+    // Rate schedule, the rates at the start of the segments and their
+    // slopes, zero unless the rate is linear
+    QVector<double> m_rateTimes;
+    QVector<double> m_rates;
+    QVector<double> m_rateSlopes;
+    QVector<double> m_majorantRates;
+    int m_segment;
+    double m_periodStart;
+    double m_time;
+
+    QSharedPointer<const EmpiricalTable> m_table;
+
+    QSharedPointer<const TraceFile> m_trace;
+    const double* m_traceValues;
+    bool m_loop;
+    bool m_exhausted;
+    quint64 m_traceOffset;
+
+    QVector<double> m_buffer;
+    int m_count;
+    int m_position;
+};
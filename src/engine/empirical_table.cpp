@@ -0,0 +1,185 @@
+#include "engine/empirical_table.hpp"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QTextStream>
+#include <QWeakPointer>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    QMutex cacheMutex;
+    QHash<QString, QWeakPointer<const EmpiricalTable>> cache;
+
+    QSharedPointer<const EmpiricalTable> read(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            return QSharedPointer<const EmpiricalTable>();
+        }
+
+        QVector<double> probabilities;
+        QVector<double> values;
+
+        QTextStream in(&file);
+        while (!in.atEnd())
+        {
+            QString line = in.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith("#"))
+            {
+                continue;
+            }
+
+            QStringList components = line.split(",");
+            if (components.size() != 2)
+            {
+                return QSharedPointer<const EmpiricalTable>();
+            }
+
+            bool probabilityOk = false;
+            bool valueOk = false;
+            probabilities.append(components[0].toDouble(&probabilityOk));
+            values.append(components[1].toDouble(&valueOk));
+            if (!probabilityOk || !valueOk)
+            {
+                return QSharedPointer<const EmpiricalTable>();
+            }
+        }
+
+        return EmpiricalTable::create(probabilities, values, path);
+    }
+}
+
+
+EmpiricalTable::EmpiricalTable()
+{}
+
+QSharedPointer<const EmpiricalTable> EmpiricalTable::load(const QString& path)
+{
+    QString absolutePath = QFileInfo(path).absoluteFilePath();
+
+    QMutexLocker locker(&cacheMutex);
+
+    QSharedPointer<const EmpiricalTable> table = cache.value(absolutePath).toStrongRef();
+    if (table.isNull())
+    {
+        table = read(absolutePath);
+        if (!table.isNull())
+        {
+            cache.insert(absolutePath, table);
+        }
+    }
+
+    return table;
+}
+
+QSharedPointer<const EmpiricalTable> EmpiricalTable::create(const QVector<double>& probabilities,
+                                                            const QVector<double>& values,
+                                                            const QString& path)
+{
+    int pointCount = probabilities.size();
+    if (pointCount < 2 || values.size() != pointCount
+        || probabilities.first() != 0.0 || probabilities.last() != 1.0)
+    {
+        return QSharedPointer<const EmpiricalTable>();
+    }
+
+    for (int i = 0; i < pointCount; ++i)
+    {
+        if (!std::isfinite(values.at(i)))
+        {
+            return QSharedPointer<const EmpiricalTable>();
+        }
+
+        if (i > 0 && (probabilities.at(i) < probabilities.at(i - 1) || values.at(i) < values.at(i - 1)))
+        {
+            return QSharedPointer<const EmpiricalTable>();
+        }
+    }
+
+    EmpiricalTable* table = new EmpiricalTable();
+    table->m_path = path;
+    table->m_probabilities = probabilities;
+    table->m_values = values;
+
+    // Entry k holds the last point at or below k / guideSize, capped at the
+    // start of the last segment
+    int segmentCount = pointCount - 1;
+    int guideSize = segmentCount;
+    table->m_guide.resize(guideSize);
+
+    int point = 0;
+    for (int k = 0; k < guideSize; ++k)
+    {
+        double probability = static_cast<double>(k) / guideSize;
+        while (point < segmentCount - 1 && probabilities.at(point + 1) <= probability)
+        {
+            ++point;
+        }
+        table->m_guide[k] = point;
+    }
+
+    return QSharedPointer<const EmpiricalTable>(table);
+}
+
+QString EmpiricalTable::getPath() const
+{
+    return m_path;
+}
+
+int EmpiricalTable::size() const
+{
+    return m_probabilities.size();
+}
+
+double EmpiricalTable::getProbability(int index) const
+{
+    return m_probabilities.at(index);
+}
+
+double EmpiricalTable::getValue(int index) const
+{
+    return m_values.at(index);
+}
+
+double EmpiricalTable::getMean() const
+{
+    double mean = 0.0;
+    for (int i = 1; i < m_probabilities.size(); ++i)
+    {
+        double weight = m_probabilities.at(i) - m_probabilities.at(i - 1);
+        mean += weight * (m_values.at(i - 1) + m_values.at(i)) / 2.0;
+    }
+
+    return mean;
+}
+
+// Expects a probability in [0, 1)
+double EmpiricalTable::getQuantile(double probability) const
+{
+    int lastSegment = m_probabilities.size() - 2;
+    int guideIndex = std::min(static_cast<int>(probability * m_guide.size()), m_guide.size() - 1);
+
+    int point = m_guide.at(guideIndex);
+    while (point < lastSegment && m_probabilities.at(point + 1) <= probability)
+    {
+        ++point;
+    }
+
+    double lowProbability = m_probabilities.at(point);
+    double highProbability = m_probabilities.at(point + 1);
+    if (highProbability <= lowProbability)
+    {
+        return m_values.at(point + 1);
+    }
+
+    double fraction = (probability - lowProbability) / (highProbability - lowProbability);
+    return m_values.at(point) + fraction * (m_values.at(point + 1) - m_values.at(point));
+}
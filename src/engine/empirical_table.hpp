@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+
+// Piecewise linear inverse distribution function given by points of
+// cumulative probability and value. A guide table maps equal slices of
+// [0, 1] to the first point above them, so a lookup takes constant
+// expected time. Tables loaded from a file are cached, so all stations
+// using the same file share a single table.
+class EmpiricalTable
+{
+public:
+    // Reads lines of "probability,value", returns null for a missing or
+    // invalid file
+    static QSharedPointer<const EmpiricalTable> load(const QString& path);
+
+    // Probabilities have to go from 0 to 1 and both probabilities and
+    // values must not decrease, returns null otherwise
+    static QSharedPointer<const EmpiricalTable> create(const QVector<double>& probabilities,
+                                                       const QVector<double>& values,
+                                                       const QString& path = QString());
+
+    QString getPath() const;
+    int size() const;
+    double getProbability(int index) const;
+    double getValue(int index) const;
+    double getMean() const;
+
+    double getQuantile(double probability) const;
+
+private:
+    EmpiricalTable();
+
+private:
+    QString m_path;
+    QVector<double> m_probabilities;
+    QVector<double> m_values;
+    QVector<int> m_guide;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "engine/event.hpp"
+
+// Receives every event processed by a Simulation, including the zero-time
+// transitions which are run inline in fused mode and never returned from
+// Simulation::simulateNextStep().
+class EventListener
+{
+public:
+    virtual ~EventListener() {}
+
+    virtual void eventProcessed(const Event& event) = 0;
+};
@@ -1,48 +1,28 @@
 #include "engine/event_priority_queue.hpp"
 
-void EventPriorityQueue::enqueue(Event event)
-{
-    if (m_queue.isEmpty() || event.time > m_queue.back().time)
-    {
-        m_queue.enqueue(event);
-    }
-    else
-    {
-        auto it = m_queue.begin();
-        for (; it != m_queue.end(); ++it)
-        {
-            if (event.time < it->time)
-            {
-                break;
-            }
-        }
+#include "engine/calendar_event_priority_queue.hpp"
+#include "engine/heap_event_priority_queue.hpp"
+#include "engine/radix_heap_event_priority_queue.hpp"
 
-        m_queue.insert(it, event);
-    }
-}
 
-Event EventPriorityQueue::dequeue()
+EventPriorityQueue* EventPriorityQueue::create(EventQueueType type, const TickResolution& resolution)
 {
-    return m_queue.dequeue();
-}
+    EventPriorityQueue* queue = nullptr;
 
-Event EventPriorityQueue::head()
-{
-    return m_queue.head();
-}
+    switch (type)
+    {
+        case EventQueueType::Heap:
+            queue = new HeapEventPriorityQueue();
+            break;
 
-bool EventPriorityQueue::isEmpty() const
-{
-    return m_queue.isEmpty();
-}
+        case EventQueueType::Calendar:
+            queue = new CalendarEventPriorityQueue();
+            break;
 
-void EventPriorityQueue::clear()
-{
-    m_queue.clear();
-}
+        case EventQueueType::RadixHeap:
+            queue = new RadixHeapEventPriorityQueue(resolution);
+            break;
+    }
 
-QList<Event> EventPriorityQueue::getAll() const
-{
-    return m_queue;
+    return queue;
 }
-
@@ -1,22 +1,59 @@
 #pragma once
 
 #include "engine/event.hpp"
+#include "engine/tick_time.hpp"
 
-#include <QQueue>
+#include <QList>
 
 
+enum class EventQueueType
+{
+    Heap,
+    Calendar,
+    RadixHeap
+};
+
+// Future event set. Implementations must dequeue events ordered by
+// (time, insertion sequence), so all of them produce the same event order.
 class EventPriorityQueue
 {
 public:
-    void enqueue(Event event);
-    Event dequeue();
-    Event head();
+    static EventPriorityQueue* create(EventQueueType type, const TickResolution& resolution);
+
+    virtual ~EventPriorityQueue() {}
+
+    virtual EventQueueType getType() const = 0;
+
+    virtual void enqueue(Event event) = 0;
+    virtual Event dequeue() = 0;
+    virtual Event head() = 0;
+
+    virtual bool isEmpty() const = 0;
+    virtual void clear() = 0;
+
+    // Whether an event is due at or before the given time
+    virtual bool hasEventDue(double time)
+    {
+        return !isEmpty() && head().time <= time;
+    }
+
+    // Slow path for debugging only: returns a sorted copy of all events
+    virtual QList<Event> getAll() const = 0;
 
-    bool isEmpty() const;
-    void clear();
+protected:
+    struct QueuedEvent
+    {
+        Event event;
+        quint64 sequence;
+    };
 
-    QList<Event> getAll() const;
+    static bool isBefore(const QueuedEvent& a, const QueuedEvent& b)
+    {
+        if (a.event.time != b.event.time)
+        {
+            return a.event.time < b.event.time;
+        }
 
-private:
-    QQueue<Event> m_queue;
+        return a.sequence < b.sequence;
+    }
 };
@@ -0,0 +1,126 @@
+#include "engine/heap_event_priority_queue.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    const int HEAP_ARITY = 4;
+}
+
+
+HeapEventPriorityQueue::HeapEventPriorityQueue()
+ : m_nextSequence(0)
+{}
+
+EventQueueType HeapEventPriorityQueue::getType() const
+{
+    return EventQueueType::Heap;
+}
+
+void HeapEventPriorityQueue::enqueue(Event event)
+{
+    QueuedEvent queuedEvent;
+    queuedEvent.event = event;
+    queuedEvent.sequence = m_nextSequence++;
+
+    m_heap.append(queuedEvent);
+    siftUp(m_heap.size() - 1);
+}
+
+Event HeapEventPriorityQueue::dequeue()
+{
+    Event event = m_heap.first().event;
+
+    m_heap.first() = m_heap.last();
+    m_heap.removeLast();
+
+    if (!m_heap.isEmpty())
+    {
+        siftDown(0);
+    }
+
+    return event;
+}
+
+Event HeapEventPriorityQueue::head()
+{
+    return m_heap.first().event;
+}
+
+bool HeapEventPriorityQueue::isEmpty() const
+{
+    return m_heap.isEmpty();
+}
+
+void HeapEventPriorityQueue::clear()
+{
+    m_heap.clear();
+    m_nextSequence = 0;
+}
+
+QList<Event> HeapEventPriorityQueue::getAll() const
+{
+    QVector<QueuedEvent> sortedEvents = m_heap;
+    std::sort(sortedEvents.begin(), sortedEvents.end(), &EventPriorityQueue::isBefore);
+
+    QList<Event> events;
+    for (const QueuedEvent& queuedEvent : sortedEvents)
+    {
+        events.append(queuedEvent.event);
+    }
+    return events;
+}
+
+void HeapEventPriorityQueue::siftUp(int index)
+{
+    QueuedEvent queuedEvent = m_heap.at(index);
+
+    while (index > 0)
+    {
+        int parent = (index - 1) / HEAP_ARITY;
+        if (!isBefore(queuedEvent, m_heap.at(parent)))
+        {
+            break;
+        }
+
+        m_heap[index] = m_heap.at(parent);
+        index = parent;
+    }
+
+    m_heap[index] = queuedEvent;
+}
+
+void HeapEventPriorityQueue::siftDown(int index)
+{
+    const int size = m_heap.size();
+    QueuedEvent queuedEvent = m_heap.at(index);
+
+    while (true)
+    {
+        int firstChild = index * HEAP_ARITY + 1;
+        if (firstChild >= size)
+        {
+            break;
+        }
+
+        int lastChild = std::min(firstChild + HEAP_ARITY, size);
+        int smallestChild = firstChild;
+        for (int child = firstChild + 1; child < lastChild; ++child)
+        {
+            if (isBefore(m_heap.at(child), m_heap.at(smallestChild)))
+            {
+                smallestChild = child;
+            }
+        }
+
+        if (!isBefore(m_heap.at(smallestChild), queuedEvent))
+        {
+            break;
+        }
+
+        m_heap[index] = m_heap.at(smallestChild);
+        index = smallestChild;
+    }
+
+    m_heap[index] = queuedEvent;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "engine/event_priority_queue.hpp"
+
+#include <QVector>
+
+
+// Future event set kept as a 4-ary min-heap ordered by (time, insertion
+// sequence), so events scheduled for the same time are dequeued in FIFO order.
+class HeapEventPriorityQueue : public EventPriorityQueue
+{
+public:
+    HeapEventPriorityQueue();
+
+    virtual EventQueueType getType() const override;
+
+    virtual void enqueue(Event event) override;
+    virtual Event dequeue() override;
+    virtual Event head() override;
+
+    virtual bool isEmpty() const override;
+    virtual void clear() override;
+
+    virtual QList<Event> getAll() const override;
+
+private:
+    void siftUp(int index);
+    void siftDown(int index);
+
+private:
+    QVector<QueuedEvent> m_heap;
+    quint64 m_nextSequence;
+};
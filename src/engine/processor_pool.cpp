@@ -0,0 +1,134 @@
+#include "engine/processor_pool.hpp"
+
+#include "engine/event.hpp"
+
+namespace
+{
+    const int BITS_PER_WORD = 64;
+
+    inline int findFirstSetBit(quint64 word)
+    {
+        return __builtin_ctzll(word);
+    }
+}
+
+
+void ProcessorPool::Bitmap::reset(int size)
+{
+    int wordCount = (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    m_words.fill(0, wordCount);
+    m_summary.fill(0, (wordCount + BITS_PER_WORD - 1) / BITS_PER_WORD);
+    m_count = 0;
+}
+
+void ProcessorPool::Bitmap::set(int index)
+{
+    int word = index / BITS_PER_WORD;
+    quint64 bit = Q_UINT64_C(1) << (index % BITS_PER_WORD);
+    if ((m_words.at(word) & bit) == 0)
+    {
+        m_words[word] |= bit;
+        m_summary[word / BITS_PER_WORD] |= Q_UINT64_C(1) << (word % BITS_PER_WORD);
+        ++m_count;
+    }
+}
+
+void ProcessorPool::Bitmap::clear(int index)
+{
+    int word = index / BITS_PER_WORD;
+    quint64 bit = Q_UINT64_C(1) << (index % BITS_PER_WORD);
+    if ((m_words.at(word) & bit) != 0)
+    {
+        m_words[word] &= ~bit;
+        if (m_words.at(word) == 0)
+        {
+            m_summary[word / BITS_PER_WORD] &= ~(Q_UINT64_C(1) << (word % BITS_PER_WORD));
+        }
+        --m_count;
+    }
+}
+
+int ProcessorPool::Bitmap::findFirst() const
+{
+    for (int i = 0; i < m_summary.size(); ++i)
+    {
+        if (m_summary.at(i) != 0)
+        {
+            int word = i * BITS_PER_WORD + findFirstSetBit(m_summary.at(i));
+            return word * BITS_PER_WORD + findFirstSetBit(m_words.at(word));
+        }
+    }
+
+    return -1;
+}
+
+bool ProcessorPool::Bitmap::isEmpty() const
+{
+    return m_count == 0;
+}
+
+////////////////////////////////////////////////
+
+ProcessorPool::ProcessorPool()
+{
+    reset(0);
+}
+
+void ProcessorPool::reset(int processorCount)
+{
+    m_tasks.fill(EMPTY_TASK_ID, processorCount);
+    m_taskProcessors.clear();
+
+    m_freeProcessors.reset(processorCount);
+    for (int i = 0; i < processorCount; ++i)
+    {
+        m_freeProcessors.set(i);
+    }
+}
+
+bool ProcessorPool::hasFreeProcessor() const
+{
+    return !m_freeProcessors.isEmpty();
+}
+
+void ProcessorPool::startTask(int taskId)
+{
+    int processor = m_freeProcessors.findFirst();
+    if (processor < 0)
+    {
+        return;
+    }
+
+    m_freeProcessors.clear(processor);
+    m_tasks[processor] = taskId;
+    m_taskProcessors.insert(taskId, processor);
+}
+
+void ProcessorPool::blockTask(int taskId)
+{
+    int processor = m_taskProcessors.value(taskId, -1);
+    if (processor < 0)
+    {
+        return;
+    }
+
+    m_tasks[processor] = -taskId;
+}
+
+void ProcessorPool::releaseTask(int taskId)
+{
+    int processor = m_taskProcessors.value(taskId, -1);
+    if (processor < 0 || m_tasks.at(processor) != -taskId)
+    {
+        return;
+    }
+
+    m_taskProcessors.remove(taskId);
+    m_tasks[processor] = EMPTY_TASK_ID;
+    m_freeProcessors.set(processor);
+}
+
+QList<int> ProcessorPool::toList() const
+{
+    return m_tasks.toList();
+}
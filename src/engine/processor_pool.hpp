@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+
+// Processors of a station. Each one is free, busy with a task or blocked,
+// i.e. holding a task which has been processed but has not left the station
+// yet. Free processors are kept in a two-level bitmap, so the lowest one is
+// found with find-first-set instead of a scan.
+class ProcessorPool
+{
+public:
+    ProcessorPool();
+
+    void reset(int processorCount);
+
+    bool hasFreeProcessor() const;
+
+    // Occupies the lowest free processor
+    void startTask(int taskId);
+    void blockTask(int taskId);
+    void releaseTask(int taskId);
+
+    // Processor contents in the legacy form: EMPTY_TASK_ID for free
+    // processors, negated task ids for blocked ones
+    QList<int> toList() const;
+
+private:
+    class Bitmap
+    {
+    public:
+        void reset(int size);
+        void set(int index);
+        void clear(int index);
+        int findFirst() const;
+        bool isEmpty() const;
+
+    private:
+        QVector<quint64> m_words;
+        QVector<quint64> m_summary;
+        int m_count;
+    };
+
+private:
+    QVector<int> m_tasks;
+    QHash<int, int> m_taskProcessors;
+    Bitmap m_freeProcessors;
+};
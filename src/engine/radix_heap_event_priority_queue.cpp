@@ -0,0 +1,200 @@
+#include "engine/radix_heap_event_priority_queue.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    const quint64 SIGN_BIT = Q_UINT64_C(1) << 63;
+}
+
+
+RadixHeapEventPriorityQueue::RadixHeapEventPriorityQueue(const TickResolution& resolution)
+ : m_resolution(resolution)
+ , m_currentBucketHead(0)
+ , m_lastKey(0)
+ , m_size(0)
+ , m_nextSequence(0)
+{}
+
+EventQueueType RadixHeapEventPriorityQueue::getType() const
+{
+    return EventQueueType::RadixHeap;
+}
+
+void RadixHeapEventPriorityQueue::enqueue(Event event)
+{
+    KeyedEvent keyedEvent;
+    keyedEvent.key = std::max(getKey(event.time), m_lastKey);
+    keyedEvent.queuedEvent.event = event;
+    keyedEvent.queuedEvent.sequence = m_nextSequence++;
+
+    push(keyedEvent);
+    ++m_size;
+}
+
+Event RadixHeapEventPriorityQueue::dequeue()
+{
+    refillCurrentBucket();
+
+    QVector<KeyedEvent>& currentBucket = m_buckets[0];
+    Event event = currentBucket.at(m_currentBucketHead++).queuedEvent.event;
+    if (m_currentBucketHead == currentBucket.size())
+    {
+        currentBucket.clear();
+        m_currentBucketHead = 0;
+    }
+
+    --m_size;
+    return event;
+}
+
+Event RadixHeapEventPriorityQueue::head()
+{
+    refillCurrentBucket();
+
+    return m_buckets[0].at(m_currentBucketHead).queuedEvent.event;
+}
+
+bool RadixHeapEventPriorityQueue::isEmpty() const
+{
+    return m_size == 0;
+}
+
+// Answered without peeking at the next key, which would clamp the events
+// enqueued before it to that key
+bool RadixHeapEventPriorityQueue::hasEventDue(double time)
+{
+    quint64 key = getKey(time);
+    if (m_currentBucketHead < m_buckets[0].size())
+    {
+        return m_lastKey <= key;
+    }
+
+    if (m_lastKey >= key)
+    {
+        return false;
+    }
+
+    // All other keys are above m_lastKey, the smallest of them is in the
+    // first non-empty bucket
+    int index = 1;
+    while (index < BUCKET_COUNT && m_buckets[index].isEmpty())
+    {
+        ++index;
+    }
+
+    if (index == BUCKET_COUNT)
+    {
+        return false;
+    }
+
+    for (const KeyedEvent& keyedEvent : m_buckets[index])
+    {
+        if (keyedEvent.key <= key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RadixHeapEventPriorityQueue::clear()
+{
+    for (QVector<KeyedEvent>& bucket : m_buckets)
+    {
+        bucket.clear();
+    }
+
+    m_currentBucketHead = 0;
+    m_lastKey = 0;
+    m_size = 0;
+    m_nextSequence = 0;
+}
+
+QList<Event> RadixHeapEventPriorityQueue::getAll() const
+{
+    QVector<KeyedEvent> keyedEvents;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        int first = (i == 0) ? m_currentBucketHead : 0;
+        for (int j = first; j < m_buckets[i].size(); ++j)
+        {
+            keyedEvents.append(m_buckets[i].at(j));
+        }
+    }
+
+    std::sort(keyedEvents.begin(), keyedEvents.end(), [](const KeyedEvent& a, const KeyedEvent& b) -> bool
+    {
+        if (a.key != b.key)
+        {
+            return a.key < b.key;
+        }
+        return a.queuedEvent.sequence < b.queuedEvent.sequence;
+    });
+
+    QList<Event> events;
+    for (const KeyedEvent& keyedEvent : keyedEvents)
+    {
+        events.append(keyedEvent.queuedEvent.event);
+    }
+    return events;
+}
+
+// Maps signed ticks to unsigned keys preserving their order
+quint64 RadixHeapEventPriorityQueue::getKey(double time) const
+{
+    return static_cast<quint64>(m_resolution.toTicks(time)) ^ SIGN_BIT;
+}
+
+int RadixHeapEventPriorityQueue::getBucketIndex(quint64 key) const
+{
+    if (key == m_lastKey)
+    {
+        return 0;
+    }
+
+    return 64 - __builtin_clzll(key ^ m_lastKey);
+}
+
+void RadixHeapEventPriorityQueue::push(const KeyedEvent& keyedEvent)
+{
+    m_buckets[getBucketIndex(keyedEvent.key)].append(keyedEvent);
+}
+
+// Makes bucket 0 (events due at m_lastKey) non-empty by advancing m_lastKey
+// to the smallest key of the first non-empty bucket and redistributing it.
+// Bucket 0 is then sorted by sequence; later insertions into it are newer, so
+// it stays in FIFO order.
+void RadixHeapEventPriorityQueue::refillCurrentBucket()
+{
+    if (m_currentBucketHead < m_buckets[0].size())
+    {
+        return;
+    }
+
+    int index = 1;
+    while (m_buckets[index].isEmpty())
+    {
+        ++index;
+    }
+
+    QVector<KeyedEvent> bucket;
+    bucket.swap(m_buckets[index]);
+
+    quint64 minKey = bucket.first().key;
+    for (const KeyedEvent& keyedEvent : bucket)
+    {
+        minKey = std::min(minKey, keyedEvent.key);
+    }
+
+    m_lastKey = minKey;
+    for (const KeyedEvent& keyedEvent : bucket)
+    {
+        push(keyedEvent);
+    }
+
+    std::sort(m_buckets[0].begin(), m_buckets[0].end(), [](const KeyedEvent& a, const KeyedEvent& b) -> bool
+    {
+        return a.queuedEvent.sequence < b.queuedEvent.sequence;
+    });
+}
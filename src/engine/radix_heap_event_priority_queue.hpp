@@ -0,0 +1,53 @@
+#pragma once
+
+#include "engine/event_priority_queue.hpp"
+#include "engine/tick_time.hpp"
+
+#include <QVector>
+
+
+// Radix heap over integer tick time. Relies on the keys of enqueued events
+// never being smaller than the key of the last dequeued (or peeked) event,
+// which holds for discrete-event simulation time; events scheduled in the
+// past are treated as due at that key. Events with equal ticks are dequeued
+// in FIFO order.
+class RadixHeapEventPriorityQueue : public EventPriorityQueue
+{
+public:
+    explicit RadixHeapEventPriorityQueue(const TickResolution& resolution);
+
+    virtual EventQueueType getType() const override;
+
+    virtual void enqueue(Event event) override;
+    virtual Event dequeue() override;
+    virtual Event head() override;
+
+    virtual bool isEmpty() const override;
+    virtual void clear() override;
+
+    virtual bool hasEventDue(double time) override;
+
+    virtual QList<Event> getAll() const override;
+
+private:
+    struct KeyedEvent
+    {
+        quint64 key;
+        QueuedEvent queuedEvent;
+    };
+
+    static const int BUCKET_COUNT = 65;
+
+    quint64 getKey(double time) const;
+    int getBucketIndex(quint64 key) const;
+    void push(const KeyedEvent& keyedEvent);
+    void refillCurrentBucket();
+
+private:
+    TickResolution m_resolution;
+    QVector<KeyedEvent> m_buckets[BUCKET_COUNT];
+    int m_currentBucketHead;
+    quint64 m_lastKey;
+    int m_size;
+    quint64 m_nextSequence;
+};
@@ -0,0 +1,79 @@
+#include "engine/random_stream.hpp"
+
+#include <boost/random/seed_seq.hpp>
+
+
+RandomStream::RandomStream()
+ : m_generatorType(RandomGeneratorType::MersenneTwister)
+ , m_complementMask(0)
+ , m_state{1, 0, 0, 0}
+{}
+
+void RandomStream::setGeneratorType(RandomGeneratorType type)
+{
+    m_generatorType = type;
+}
+
+RandomGeneratorType RandomStream::getGeneratorType() const
+{
+    return m_generatorType;
+}
+
+void RandomStream::setAntithetic(bool antithetic)
+{
+    m_complementMask = antithetic ? ~quint64(0) : 0;
+}
+
+bool RandomStream::isAntithetic() const
+{
+    return m_complementMask != 0;
+}
+
+void RandomStream::seed(quint64 seed, quint64 replication, RandomStreamType type, int stationId)
+{
+    boost::random::seed_seq seedSequence =
+    {
+        static_cast<quint32>(seed),
+        static_cast<quint32>(seed >> 32),
+        static_cast<quint32>(replication),
+        static_cast<quint32>(replication >> 32),
+        static_cast<quint32>(type),
+        static_cast<quint32>(stationId)
+    };
+
+    if (m_generatorType == RandomGeneratorType::MersenneTwister)
+    {
+        m_mersenneTwister.seed(seedSequence);
+        return;
+    }
+
+    quint32 words[8];
+    seedSequence.generate(words, words + 8);
+    for (int i = 0; i < 4; ++i)
+    {
+        m_state[i] = (static_cast<quint64>(words[2*i]) << 32) | words[2*i + 1];
+    }
+
+    // The all-zero state is a fixed point of xoshiro
+    if ((m_state[0] | m_state[1] | m_state[2] | m_state[3]) == 0)
+    {
+        m_state[0] = 1;
+    }
+}
+
+void RandomStream::fill(quint64* values, int count)
+{
+    if (m_generatorType == RandomGeneratorType::Xoshiro256PlusPlus)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = nextXoshiro() ^ m_complementMask;
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] = m_mersenneTwister() ^ m_complementMask;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <boost/random/mersenne_twister.hpp>
+
+#include <algorithm>
+
+const quint64 DEFAULT_RANDOM_SEED = 5489;
+
+// Purpose of a random stream. Every station has its own service, routing
+// and queue selection stream, arrivals use the stream of the input station.
+enum class RandomStreamType
+{
+    Arrival,
+    Service,
+    Routing,
+    QueueSelection
+};
+
+enum class RandomGeneratorType
+{
+    MersenneTwister,
+    Xoshiro256PlusPlus
+};
+
+// Independently seeded random number generator for one purpose of one
+// station. The seed is derived from the base seed, the replication number,
+// the purpose and the station id, so draws of a stream do not depend on how
+// many numbers the other streams have used. This keeps random numbers common
+// between runs of configurations which differ in a single station.
+class RandomStream
+{
+public:
+    RandomStream();
+
+    void setGeneratorType(RandomGeneratorType type);
+    RandomGeneratorType getGeneratorType() const;
+
+    // An antithetic stream returns the complement of every number, so each
+    // uniform U becomes 1 - U
+    void setAntithetic(bool antithetic);
+    bool isAntithetic() const;
+
+    void seed(quint64 seed, quint64 replication, RandomStreamType type, int stationId);
+
+    quint64 next64()
+    {
+        if (m_generatorType == RandomGeneratorType::Xoshiro256PlusPlus)
+        {
+            return nextXoshiro() ^ m_complementMask;
+        }
+
+        return m_mersenneTwister() ^ m_complementMask;
+    }
+
+    // Uniform in the open interval (0, 1), so safe to take a logarithm of
+    double nextDouble()
+    {
+        return toDouble(next64());
+    }
+
+    // 52 bits are used, so that the result can not round up to 1 and the
+    // complement of the bits gives exactly 1 - U
+    static double toDouble(quint64 bits)
+    {
+        return ((bits >> 12) + 0.5) * (1.0 / 4503599627370496.0);
+    }
+
+    // Uniform in [0, count), by inverse transform so that antithetic
+    // streams give mirrored choices
+    int nextIndex(int count)
+    {
+        return std::min(static_cast<int>(nextDouble() * count), count - 1);
+    }
+
+    void fill(quint64* values, int count);
+
+private:
+    static quint64 rotateLeft(quint64 value, int shift)
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    quint64 nextXoshiro()
+    {
+        quint64 result = rotateLeft(m_state[0] + m_state[3], 23) + m_state[0];
+        quint64 shifted = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= shifted;
+        m_state[3] = rotateLeft(m_state[3], 45);
+
+        return result;
+    }
+
+private:
+    RandomGeneratorType m_generatorType;
+    quint64 m_complementMask;
+    boost::random::mt19937_64 m_mersenneTwister;
+    quint64 m_state[4];
+};
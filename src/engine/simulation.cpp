@@ -8,8 +8,6 @@
 #include <QStack>
 #include <QSet>
 
-namespace rnd = boost::random;
-
 
 Simulation::WorkingStation::WorkingStation(const Station& station)
 {
@@ -17,18 +15,17 @@ Simulation::WorkingStation::WorkingStation(const Station& station)
     resetStateParams();
 }
 
+bool Simulation::WorkingStation::hasPlaceInQueue() const
+{
+    return !tasksInQueue.isFull();
+}
+
 void Simulation::WorkingStation::resetStateParams()
 {
-    tasksInQueue.clear();
-    for (int i = 0; i < queueLength; ++i)
-    {
-        tasksInQueue.append(EMPTY_TASK_ID);
-    }
-    tasksInProcessors.clear();
-    for (int i = 0; i < processorCount; ++i)
-    {
-        tasksInProcessors.append(EMPTY_TASK_ID);
-    }
+    tasksInQueue.reset(queueLength);
+    tasksInProcessors.reset(processorCount);
+    blockedTasks.clear();
+    blockedUpstreamTasks.clear();
 }
 
 ////////////////////////////////////////////////
@@ -39,6 +36,7 @@ Simulation::WorkingInstance::WorkingInstance()
 Simulation::WorkingInstance::WorkingInstance(const SimulationInstance& simulationInstance)
  : arrivalTimeDistribution(simulationInstance.arrivalTimeDistribution)
  , connections(simulationInstance.connections)
+ , arrivalSources(simulationInstance.arrivalSources)
 {
     setStations(simulationInstance.stations);
 }
@@ -47,6 +45,7 @@ Simulation::WorkingInstance& Simulation::WorkingInstance::operator=(const Simula
 {
     arrivalTimeDistribution = simulationInstance.arrivalTimeDistribution;
     connections = simulationInstance.connections;
+    arrivalSources = simulationInstance.arrivalSources;
     setStations(simulationInstance.stations);
     return *this;
 }
@@ -59,6 +58,72 @@ void Simulation::WorkingInstance::setStations(const QList<Station>& stations)
     {
         workingStations.append(WorkingStation(baseStation));
     }
+
+    rebuildIndices();
+}
+
+void Simulation::WorkingInstance::rebuildIndices()
+{
+    int maxStationId = OUTPUT_STATION_ID;
+    for (const WorkingStation& workingStation : workingStations)
+    {
+        maxStationId = std::max(maxStationId, workingStation.id);
+    }
+
+    stationIndices.fill(-1, maxStationId - OUTPUT_STATION_ID + 1);
+
+    for (int i = 0; i < workingStations.size(); ++i)
+    {
+        stationIndices[workingStations.at(i).id - OUTPUT_STATION_ID] = i;
+    }
+
+    connectionGraph.build(connections, stationIndices, workingStations.size());
+
+    rebuildRouting();
+}
+
+void Simulation::WorkingInstance::rebuildRouting()
+{
+    for (int i = 0; i < workingStations.size(); ++i)
+    {
+        ConnectionGraph::Range outgoing = connectionGraph.getOutgoing(i);
+
+        QVector<int> weights;
+        weights.reserve(outgoing.size());
+        for (const Connection& connection : outgoing)
+        {
+            const WorkingStation& connectedStation = workingStations.at(getStationIndex(connection.to));
+            weights.append(connectedStation.hasPlaceInQueue() ? connection.weight : 0);
+        }
+
+        workingStations[i].routingSelector.reset(weights);
+    }
+}
+
+// Called when a station's queue becomes full or gets place again, enables
+// or disables the connections leading to it in the upstream selectors
+void Simulation::WorkingInstance::updateRouting(int stationIndex)
+{
+    bool hasPlace = workingStations.at(stationIndex).hasPlaceInQueue();
+
+    ConnectionGraph::Range incoming = connectionGraph.getIncoming(stationIndex);
+    for (int i = 0; i < incoming.size(); ++i)
+    {
+        ConnectionGraph::IncomingSource source = connectionGraph.getIncomingSource(stationIndex, i);
+        int weight = hasPlace ? incoming.at(i).weight : 0;
+        workingStations[source.stationIndex].routingSelector.setWeight(source.position, weight);
+    }
+}
+
+int Simulation::WorkingInstance::getStationIndex(int stationId) const
+{
+    int key = stationId - OUTPUT_STATION_ID;
+    if (key < 0 || key >= stationIndices.size())
+    {
+        return -1;
+    }
+
+    return stationIndices.at(key);
 }
 
 SimulationInstance Simulation::WorkingInstance::toSimulationInstance() const
@@ -67,6 +132,7 @@ SimulationInstance Simulation::WorkingInstance::toSimulationInstance() const
 
     simulationInstance.arrivalTimeDistribution = arrivalTimeDistribution;
     simulationInstance.connections = connections;
+    simulationInstance.arrivalSources = arrivalSources;
 
     for (const WorkingStation& workingStation : workingStations)
     {
@@ -80,11 +146,188 @@ SimulationInstance Simulation::WorkingInstance::toSimulationInstance() const
 ////////////////////////////////////////////////
 
 Simulation::Simulation()
- : m_nextStationId(1)
+ : m_eventQueue(EventPriorityQueue::create(EventQueueType::Heap, TickResolution()))
+ , m_fusedTransitions(false)
+ , m_unblockingPolicy(UnblockingPolicy::Fifo)
+ , m_nextBlockSequence(0)
+ , m_nextStationId(1)
  , m_nextTaskId(1)
  , m_currentTime(0.0)
+ , m_currentTicks(0)
+ , m_processedEventCount(0)
+ , m_completedTaskCount(0)
+ , m_traceEnded(false)
+ , m_randomSeed(DEFAULT_RANDOM_SEED)
+ , m_replication(0)
+ , m_randomGeneratorType(RandomGeneratorType::MersenneTwister)
+ , m_samplingMethod(SamplingMethod::Ziggurat)
+ , m_antithetic(false)
 {}
 
+void Simulation::setEventQueueType(EventQueueType type)
+{
+    if (type == m_eventQueue->getType())
+    {
+        return;
+    }
+
+    if (type == EventQueueType::RadixHeap && !m_tickResolution.isEnabled())
+    {
+        m_tickResolution = TickResolution(DEFAULT_TICKS_PER_TIME_UNIT);
+        m_currentTicks = m_tickResolution.toTicks(m_currentTime);
+    }
+
+    rebuildEventQueue(type);
+}
+
+EventQueueType Simulation::getEventQueueType() const
+{
+    return m_eventQueue->getType();
+}
+
+void Simulation::setTickResolution(double ticksPerTimeUnit)
+{
+    m_tickResolution = TickResolution(std::max(ticksPerTimeUnit, 0.0));
+    m_currentTicks = m_tickResolution.isEnabled() ? m_tickResolution.toTicks(m_currentTime) : 0;
+
+    EventQueueType type = m_eventQueue->getType();
+    if (type == EventQueueType::RadixHeap && !m_tickResolution.isEnabled())
+    {
+        type = EventQueueType::Heap;
+    }
+
+    rebuildEventQueue(type);
+}
+
+double Simulation::getTickResolution() const
+{
+    return m_tickResolution.ticksPerTimeUnit;
+}
+
+void Simulation::setFusedTransitions(bool fused)
+{
+    m_fusedTransitions = fused;
+}
+
+bool Simulation::getFusedTransitions() const
+{
+    return m_fusedTransitions;
+}
+
+void Simulation::setUnblockingPolicy(UnblockingPolicy policy)
+{
+    m_unblockingPolicy = policy;
+
+    for (WorkingStation& station : m_instance.workingStations)
+    {
+        station.blockedUpstreamTasks.setPolicy(policy);
+    }
+}
+
+UnblockingPolicy Simulation::getUnblockingPolicy() const
+{
+    return m_unblockingPolicy;
+}
+
+void Simulation::setRandomSeed(quint64 seed, quint64 replication)
+{
+    m_randomSeed = seed;
+    m_replication = replication;
+}
+
+quint64 Simulation::getRandomSeed() const
+{
+    return m_randomSeed;
+}
+
+quint64 Simulation::getReplication() const
+{
+    return m_replication;
+}
+
+void Simulation::setRandomStreamSeed(RandomStreamType type, int stationId, quint64 seed)
+{
+    quint64 key = (static_cast<quint64>(type) << 32) | static_cast<quint32>(stationId);
+    m_randomStreamSeeds.insert(key, seed);
+}
+
+void Simulation::clearRandomStreamSeeds()
+{
+    m_randomStreamSeeds.clear();
+}
+
+void Simulation::setRandomGeneratorType(RandomGeneratorType type)
+{
+    m_randomGeneratorType = type;
+}
+
+RandomGeneratorType Simulation::getRandomGeneratorType() const
+{
+    return m_randomGeneratorType;
+}
+
+void Simulation::setSamplingMethod(SamplingMethod method)
+{
+    m_samplingMethod = method;
+}
+
+SamplingMethod Simulation::getSamplingMethod() const
+{
+    return m_samplingMethod;
+}
+
+void Simulation::setAntithetic(bool antithetic)
+{
+    m_antithetic = antithetic;
+}
+
+bool Simulation::isAntithetic() const
+{
+    return m_antithetic;
+}
+
+void Simulation::addEventListener(EventListener* listener)
+{
+    if (!m_eventListeners.contains(listener))
+    {
+        m_eventListeners.append(listener);
+    }
+}
+
+void Simulation::removeEventListener(EventListener* listener)
+{
+    m_eventListeners.removeOne(listener);
+}
+
+// Moves the clock forward without processing anything, used when a run
+// stops on its time limit before the next event
+void Simulation::advanceTimeTo(double time)
+{
+    if (time <= m_currentTime)
+    {
+        return;
+    }
+
+    m_currentTime = time;
+    if (m_tickResolution.isEnabled())
+    {
+        m_currentTicks = m_tickResolution.toTicks(time);
+    }
+}
+
+void Simulation::rebuildEventQueue(EventQueueType type)
+{
+    std::unique_ptr<EventPriorityQueue> eventQueue(EventPriorityQueue::create(type, m_tickResolution));
+
+    QList<Event> pendingEvents = m_eventQueue->getAll();
+    for (const Event& event : pendingEvents)
+    {
+        eventQueue->enqueue(event);
+    }
+
+    m_eventQueue = std::move(eventQueue);
+}
+
 void Simulation::setInstance(const SimulationInstance& instance)
 {
     m_instance = instance;
@@ -106,17 +349,29 @@ SimulationInstance Simulation::getInstance() const
 void Simulation::addStation(const Station& station)
 {
     m_instance.workingStations.append(WorkingStation(station));
+    seedRandomStreams(m_instance.workingStations.last());
+    m_instance.rebuildIndices();
     m_nextStationId = std::max(m_nextStationId, station.id+1);
 }
 
 void Simulation::addConnection(const Connection& connection)
 {
     m_instance.connections.append(connection);
+    m_instance.rebuildIndices();
+}
+
+Distribution Simulation::getArrivalDistribution() const
+{
+    return m_instance.arrivalTimeDistribution;
 }
 
 void Simulation::changeArrivalDistribution(const Distribution& distribution)
 {
     m_instance.arrivalTimeDistribution = distribution;
+    if (!m_arrivalSources.isEmpty())
+    {
+        m_arrivalSources.first().sampler = createSampler(distribution);
+    }
 }
 
 int Simulation::getNextStationId() const
@@ -126,27 +381,29 @@ int Simulation::getNextStationId() const
 
 Station Simulation::getStation(int id) const
 {
-    for (const WorkingStation& station : m_instance.workingStations)
+    int index = m_instance.getStationIndex(id);
+    if (index < 0)
     {
-        if (station.id == id)
-        {
-            return station;
-        }
+        return Station();
     }
 
-    return Station();
+    return m_instance.workingStations.at(index);
 }
 
 void Simulation::changeStation(int id, const StationParams& stationParams)
 {
-    for (WorkingStation& station : m_instance.workingStations)
+    int index = m_instance.getStationIndex(id);
+    if (index < 0)
     {
-        if (station.id == id)
-        {
-            station.setParams(stationParams);
-            station.resetStateParams();
-        }
+        return;
     }
+
+    WorkingStation& station = m_instance.workingStations[index];
+    station.setParams(stationParams);
+    station.resetStateParams();
+    station.serviceSampler = createSampler(station.serviceTimeDistribution);
+
+    m_instance.rebuildRouting();
 }
 
 int Simulation::getConnectionWeight(int from, int to) const
@@ -171,6 +428,10 @@ void Simulation::changeConnectionWeight(int from, int to, int weight)
             connection.weight = weight;
         }
     }
+
+    m_instance.connectionGraph.changeWeight(m_instance.getStationIndex(from), m_instance.getStationIndex(to),
+                                            from, to, weight);
+    m_instance.rebuildRouting();
 }
 
 bool Simulation::connectionExists(int from, int to) const
@@ -197,6 +458,21 @@ void Simulation::removeStation(int id)
         }
     }
 
+    m_instance.rebuildIndices();
+
+    auto arrivalSourceIt = m_instance.arrivalSources.begin();
+    while (arrivalSourceIt != m_instance.arrivalSources.end())
+    {
+        if (arrivalSourceIt->stationId == id)
+        {
+            arrivalSourceIt = m_instance.arrivalSources.erase(arrivalSourceIt);
+        }
+        else
+        {
+            ++arrivalSourceIt;
+        }
+    }
+
     auto connectionIt = m_instance.connections.begin();
     while (connectionIt != m_instance.connections.end())
     {
@@ -221,6 +497,8 @@ void Simulation::removeConnection(int from, int to)
             break;
         }
     }
+
+    m_instance.rebuildIndices();
 }
 
 void Simulation::updateStationPositions(const QMap<int, QPointF>& positions)
@@ -264,318 +542,497 @@ bool Simulation::isConnectionPossible(int from, int to) const
 void Simulation::reset()
 {
     m_currentTime = 0.0;
+    m_currentTicks = 0;
     m_nextTaskId = 1;
+    m_nextBlockSequence = 0;
+    m_processedEventCount = 0;
+    m_completedTaskCount = 0;
+    m_traceEnded = false;
 
-    m_eventQueue.clear();
-
-    Event initialTaskEvent;
-    initialTaskEvent.type = EventType::TaskInput;
-    initialTaskEvent.time = 0.0;
-    initialTaskEvent.taskId = generateTaskId();
-    m_eventQueue.enqueue(initialTaskEvent);
+    m_eventQueue->clear();
+    m_immediateEvents.clear();
+    m_transitions.resize(0);
 
     for (WorkingStation& station : m_instance.workingStations)
     {
         station.resetStateParams();
+        station.blockedUpstreamTasks.setPolicy(m_unblockingPolicy);
+        seedRandomStreams(station);
+    }
+
+    m_instance.rebuildRouting();
+
+    // The first arrival may be due at once, it still has to be queued as
+    // fused transitions are only run within a step
+    resetArrivalSources();
+    if (!m_arrivalSourceHeap.isEmpty())
+    {
+        m_eventQueue->enqueue(createArrivalEvent());
     }
 }
 
-double Simulation::getCurrentTime()
+// The input station's first task arrives at time zero, the first tasks of
+// the other sources after a draw from their distributions
+void Simulation::resetArrivalSources()
+{
+    m_arrivalSources.clear();
+    m_arrivalSourceHeap.clear();
+
+    WorkingArrivalSource inputSource;
+    inputSource.stationId = INPUT_STATION_ID;
+    inputSource.sampler = createSampler(m_instance.arrivalTimeDistribution);
+    seedRandomStream(inputSource.stream, RandomStreamType::Arrival, INPUT_STATION_ID);
+    m_arrivalSources.append(inputSource);
+
+    for (int i = 0; i < m_instance.arrivalSources.size(); ++i)
+    {
+        const ArrivalSource& arrivalSource = m_instance.arrivalSources.at(i);
+
+        WorkingArrivalSource source;
+        source.stationId = arrivalSource.stationId;
+        source.sampler = createSampler(arrivalSource.arrivalTimeDistribution);
+        seedRandomStream(source.stream, RandomStreamType::Arrival, i);
+        m_arrivalSources.append(source);
+    }
+
+    m_arrivalSourceHeap.reserve(m_arrivalSources.size());
+
+    if (m_instance.getStationIndex(INPUT_STATION_ID) >= 0)
+    {
+        m_arrivalSourceHeap.push({0.0, 0});
+    }
+
+    for (int i = 1; i < m_arrivalSources.size(); ++i)
+    {
+        WorkingArrivalSource& source = m_arrivalSources[i];
+        double delay = source.sampler.sample(source.stream);
+        if (!source.sampler.isExhausted())
+        {
+            m_arrivalSourceHeap.push({getTimeAfter(delay), i});
+        }
+    }
+}
+
+// The pending arrival is always the one of the source on top of the heap
+Event Simulation::createArrivalEvent()
+{
+    Event taskInputEvent;
+    taskInputEvent.type = EventType::TaskInput;
+    taskInputEvent.time = m_arrivalSourceHeap.head().time;
+    taskInputEvent.taskId = generateTaskId();
+    return taskInputEvent;
+}
+
+double Simulation::getCurrentTime() const
 {
     return m_currentTime;
 }
 
 double Simulation::getTimeToNextStep()
 {
-    if (m_eventQueue.isEmpty())
+    if (isImmediateEventNext() || m_eventQueue->isEmpty())
     {
         return 0.0;
     }
 
-    double nextEventTime = m_eventQueue.head().time;
+    double nextEventTime = m_eventQueue->head().time;
     return nextEventTime - m_currentTime;
 }
 
+bool Simulation::hasPendingEvents() const
+{
+    return !m_immediateEvents.isEmpty() || !m_eventQueue->isEmpty();
+}
+
+// A service time trace that is not looped has run out, the run cannot go
+// on without making up service times
+bool Simulation::isTraceEnded() const
+{
+    return m_traceEnded;
+}
+
 Event Simulation::simulateNextStep()
 {
-    Event event = m_eventQueue.dequeue();
+    Event event = dequeueNextEvent();
     processEvent(event);
     return event;
 }
 
+// Processes events in a loop until one of the limits is reached. In fused
+// mode a step may process several events, so the event limit can be
+// overshot by the zero-time events fused into the last one.
+StopReason Simulation::run(const StopCondition& condition)
+{
+    quint64 firstEventCount = m_processedEventCount;
+    quint64 firstCompletedTaskCount = m_completedTaskCount;
+    bool hasTimeLimit = condition.timeLimit < std::numeric_limits<double>::infinity();
+
+    while (true)
+    {
+        if (m_processedEventCount - firstEventCount >= condition.eventLimit)
+        {
+            return StopReason::EventLimit;
+        }
+
+        if (m_completedTaskCount - firstCompletedTaskCount >= condition.completedTaskLimit)
+        {
+            return StopReason::CompletedTaskLimit;
+        }
+
+        if (condition.predicate && condition.predicate(*this))
+        {
+            return StopReason::Predicate;
+        }
+
+        if (m_traceEnded)
+        {
+            return StopReason::TraceEnd;
+        }
+
+        if (isImmediateEventNext())
+        {
+            processEvent(m_immediateEvents.dequeue());
+            continue;
+        }
+
+        if (m_eventQueue->isEmpty())
+        {
+            if (hasTimeLimit)
+            {
+                advanceTimeTo(condition.timeLimit);
+            }
+            return StopReason::NoEvents;
+        }
+
+        if (hasTimeLimit && m_eventQueue->head().time > condition.timeLimit)
+        {
+            advanceTimeTo(condition.timeLimit);
+            return StopReason::TimeLimit;
+        }
+
+        processEvent(m_eventQueue->dequeue());
+    }
+}
+
+StopReason Simulation::runUntil(double time)
+{
+    StopCondition condition;
+    condition.timeLimit = time;
+    return run(condition);
+}
+
+StopReason Simulation::runEvents(quint64 count)
+{
+    StopCondition condition;
+    condition.eventLimit = count;
+    return run(condition);
+}
+
+StopReason Simulation::runUntilCompletedTasks(quint64 count)
+{
+    StopCondition condition;
+    condition.completedTaskLimit = count;
+    return run(condition);
+}
+
+quint64 Simulation::getProcessedEventCount() const
+{
+    return m_processedEventCount;
+}
+
+quint64 Simulation::getCompletedTaskCount() const
+{
+    return m_completedTaskCount;
+}
+
+// Zero-delay events go to a FIFO lane, so they never pay for a priority
+// queue operation
+void Simulation::scheduleEvent(const Event& event)
+{
+    if (event.time == m_currentTime)
+    {
+        scheduleTransition(event.type, event.stationId, event.taskId);
+    }
+    else
+    {
+        m_eventQueue->enqueue(event);
+    }
+}
+
+// In fused mode zero-time transitions are only noted down and run at the
+// end of the current step, without becoming queued events
+void Simulation::scheduleTransition(EventType type, int stationId, int taskId)
+{
+    if (m_fusedTransitions)
+    {
+        m_transitions.append({type, stationId, taskId});
+    }
+    else
+    {
+        m_immediateEvents.enqueue(Event(type, m_currentTime, stationId, taskId));
+    }
+}
+
+// Timed events due now were scheduled before any event in the lane, so
+// they go first, which keeps the (time, sequence) order of a single queue
+bool Simulation::isImmediateEventNext()
+{
+    return !m_immediateEvents.isEmpty() && !m_eventQueue->hasEventDue(m_currentTime);
+}
+
+Event Simulation::dequeueNextEvent()
+{
+    return isImmediateEventNext() ? m_immediateEvents.dequeue() : m_eventQueue->dequeue();
+}
+
+// With fused transitions the zero-time transitions caused by an event are
+// run as a part of it, once its handler has returned. Timed events due at
+// the same time were scheduled before any of them and go first, so the
+// transitions come in the same order as the events without fusing.
 void Simulation::processEvent(Event event)
+{
+    dispatchEvent(event);
+
+    if (!m_fusedTransitions)
+    {
+        return;
+    }
+
+    while (m_eventQueue->hasEventDue(m_currentTime))
+    {
+        dispatchEvent(m_eventQueue->dequeue());
+    }
+
+    for (int i = 0; i < m_transitions.size(); ++i)
+    {
+        Transition transition = m_transitions.at(i);
+        runTransition(transition.type, transition.stationId, transition.taskId);
+    }
+    m_transitions.resize(0);
+}
+
+void Simulation::dispatchEvent(const Event& event)
 {
     m_currentTime = event.time;
+    if (m_tickResolution.isEnabled())
+    {
+        m_currentTicks = m_tickResolution.toTicks(event.time);
+    }
+
+    runTransition(event.type, event.stationId, event.taskId);
+}
 
-    switch (event.type)
+// Listeners get the expanded event stream in both modes
+void Simulation::runTransition(EventType type, int stationId, int taskId)
+{
+    ++m_processedEventCount;
+
+    if (!m_eventListeners.isEmpty())
+    {
+        Event event(type, m_currentTime, stationId, taskId);
+        for (EventListener* listener : m_eventListeners)
+        {
+            listener->eventProcessed(event);
+        }
+    }
+
+    switch (type)
     {
         case EventType::TaskInput:
-            processTaskInput(event);
+            processTaskInput(taskId);
             break;
 
         case EventType::TaskAddedToQueue:
-            processTaskAddedToQueue(event);
+            processTaskAddedToQueue(stationId, taskId);
             break;
 
         case EventType::TaskStartedProcessing:
-            processTaskStartedProcessing(event);
+            processTaskStartedProcessing(stationId, taskId);
             break;
 
         case EventType::TaskEndedProcessing:
-            processTaskEndedProcessing(event);
+            processTaskEndedProcessing(stationId, taskId);
             break;
 
         case EventType::QueueHasPlace:
-            processTaskQueueHasPlace(event);
+            processTaskQueueHasPlace(stationId);
             break;
 
         case EventType::MachineIsIdle:
-            processTaskMachineIsIdle(event);
+            processTaskMachineIsIdle(stationId, taskId);
             break;
 
         case EventType::TaskOutput:
+            ++m_completedTaskCount;
             break;
     }
 }
 
-void Simulation::processTaskInput(Event event)
+void Simulation::processTaskInput(int taskId)
 {
-    QList<Connection> connections = getConnectionsFrom(INPUT_STATION_ID);
-    Connection connectionToFollow = chooseConnectionToFollow(connections);
+    WorkingArrivalSource& source = m_arrivalSources[m_arrivalSourceHeap.head().source];
 
-    if (connectionToFollow.from != INVALID_STATION_ID)
+    int entryStationId = INVALID_STATION_ID;
+    if (source.stationId == INPUT_STATION_ID)
     {
-        Event taskAddedToQueueEvent;
-        taskAddedToQueueEvent.type = EventType::TaskAddedToQueue;
-        taskAddedToQueueEvent.time = event.time;
-        taskAddedToQueueEvent.taskId = event.taskId;
-        taskAddedToQueueEvent.stationId = connectionToFollow.to;
-        m_eventQueue.enqueue(taskAddedToQueueEvent);
+        Connection connectionToFollow = chooseConnectionToFollow(INPUT_STATION_ID);
+        if (connectionToFollow.from != INVALID_STATION_ID)
+        {
+            entryStationId = connectionToFollow.to;
+        }
     }
     else
     {
-        Event taskOutputEvent;
-        taskOutputEvent.type = EventType::TaskOutput;
-        taskOutputEvent.time = event.time;
-        taskOutputEvent.taskId = event.taskId;
-        m_eventQueue.enqueue(taskOutputEvent);
+        int stationIndex = m_instance.getStationIndex(source.stationId);
+        if (stationIndex >= 0 && m_instance.workingStations.at(stationIndex).hasPlaceInQueue())
+        {
+            entryStationId = source.stationId;
+        }
     }
 
-    Event nextTaskEvent;
-    nextTaskEvent.type = EventType::TaskInput;
-    nextTaskEvent.time = event.time + generateTime(m_instance.arrivalTimeDistribution);
-    nextTaskEvent.taskId = generateTaskId();
-    m_eventQueue.enqueue(nextTaskEvent);
-}
-
-void Simulation::processTaskAddedToQueue(Event event)
-{
-    WorkingStation& station = getWorkingStation(event.stationId);
-
-    if (station.queueLength == 0)
+    if (entryStationId != INVALID_STATION_ID)
     {
-        station.tasksInQueue.append(event.taskId);
+        scheduleTransition(EventType::TaskAddedToQueue, entryStationId, taskId);
     }
     else
     {
-        for (int& task : station.tasksInQueue)
-        {
-            if (task == EMPTY_TASK_ID)
-            {
-                task = event.taskId;
-                break;
-            }
-        }
+        scheduleTransition(EventType::TaskOutput, INVALID_STATION_ID, taskId);
     }
 
-    bool canBeProcessed = station.tasksInProcessors.contains(EMPTY_TASK_ID);
+    // Arrivals of a source stop with the end of its arrival trace, the tasks
+    // already in the network are still served
+    double delay = source.sampler.sample(source.stream);
+    if (source.sampler.isExhausted())
+    {
+        m_arrivalSourceHeap.pop();
+    }
+    else
+    {
+        m_arrivalSourceHeap.replaceHeadTime(getTimeAfter(delay));
+    }
 
-    if (canBeProcessed)
+    if (!m_arrivalSourceHeap.isEmpty())
     {
-        Event taskStartedProcessingEvent;
-        taskStartedProcessingEvent.type = EventType::TaskStartedProcessing;
-        taskStartedProcessingEvent.time = event.time;
-        taskStartedProcessingEvent.taskId = event.taskId;
-        taskStartedProcessingEvent.stationId = event.stationId;
-        m_eventQueue.enqueue(taskStartedProcessingEvent);
+        scheduleEvent(createArrivalEvent());
     }
 }
 
-void Simulation::processTaskStartedProcessing(Event event)
+void Simulation::processTaskAddedToQueue(int stationId, int taskId)
 {
-    WorkingStation& station = getWorkingStation(event.stationId);
+    WorkingStation& station = getWorkingStation(stationId);
 
-    if (station.queueLength == 0)
-    {
-        station.tasksInQueue.removeOne(event.taskId);
-    }
-    else
+    if (station.hasPlaceInQueue())
     {
-        QList<int> newTasks;
-        for (int task : station.tasksInQueue)
-        {
-            if (task != event.taskId)
-            {
-                newTasks.append(task);
-            }
-        }
+        station.tasksInQueue.push(taskId);
 
-        for (int i = 0; i < station.tasksInQueue.size(); ++i)
+        if (!station.hasPlaceInQueue())
         {
-            if (i < newTasks.size())
-            {
-                station.tasksInQueue[i] = newTasks[i];
-            }
-            else
-            {
-                station.tasksInQueue[i] = EMPTY_TASK_ID;
-            }
+            m_instance.updateRouting(m_instance.getStationIndex(stationId));
         }
     }
 
-    for (int& processorTask : station.tasksInProcessors)
+    bool canBeProcessed = station.tasksInProcessors.hasFreeProcessor();
+
+    if (canBeProcessed)
     {
-        if (processorTask == EMPTY_TASK_ID)
-        {
-            processorTask = event.taskId;
-            break;
-        }
+        scheduleTransition(EventType::TaskStartedProcessing, stationId, taskId);
     }
-
-    Event taskQueueHasPlaceEvent;
-    taskQueueHasPlaceEvent.type = EventType::QueueHasPlace;
-    taskQueueHasPlaceEvent.time = event.time;
-    taskQueueHasPlaceEvent.stationId = event.stationId;
-    m_eventQueue.enqueue(taskQueueHasPlaceEvent);
-
-    Event taskEndedProcessingEvent;
-    taskEndedProcessingEvent.type = EventType::TaskEndedProcessing;
-    taskEndedProcessingEvent.time = event.time + generateTime(station.serviceTimeDistribution);
-    taskEndedProcessingEvent.taskId = event.taskId;
-    taskEndedProcessingEvent.stationId = event.stationId;
-    m_eventQueue.enqueue(taskEndedProcessingEvent);
 }
 
-void Simulation::processTaskQueueHasPlace(Event event)
+void Simulation::processTaskStartedProcessing(int stationId, int taskId)
 {
-    int finishedTaskFromConnectedStation = EMPTY_TASK_ID;
-    int connectedStationId = INVALID_STATION_ID;
+    WorkingStation& station = getWorkingStation(stationId);
 
-    QList<Connection> connections = getConnectionsTo(event.stationId);
-    for (const Connection& connection : connections)
+    bool hadPlace = station.hasPlaceInQueue();
+    station.tasksInQueue.remove(taskId);
+    if (!hadPlace && station.hasPlaceInQueue())
     {
-        if (connection.from == INPUT_STATION_ID)
-        {
-            continue;
-        }
+        m_instance.updateRouting(m_instance.getStationIndex(stationId));
+    }
 
-        WorkingStation& connectedStation = getWorkingStation(connection.from);
+    station.tasksInProcessors.startTask(taskId);
 
-        for (int processorTask : connectedStation.tasksInProcessors)
-        {
-            if (processorTask < 0)
-            {
-                finishedTaskFromConnectedStation = -processorTask;
-                connectedStationId = connection.from;
-                break;
-            }
-        }
+    scheduleTransition(EventType::QueueHasPlace, stationId, EMPTY_TASK_ID);
 
-        if (finishedTaskFromConnectedStation != EMPTY_TASK_ID)
-        {
-            break;
-        }
-    }
-
-    if (finishedTaskFromConnectedStation != EMPTY_TASK_ID)
+    double serviceTime = station.serviceSampler.sample(station.serviceStream);
+    if (station.serviceSampler.isExhausted())
     {
-        Event machineIsIdleEvent;
-        machineIsIdleEvent.type = EventType::MachineIsIdle;
-        machineIsIdleEvent.time = event.time;
-        machineIsIdleEvent.taskId = finishedTaskFromConnectedStation;
-        machineIsIdleEvent.stationId = connectedStationId;
-        m_eventQueue.enqueue(machineIsIdleEvent);
-
-        Event taskAddedToQueueEvent;
-        taskAddedToQueueEvent.type = EventType::TaskAddedToQueue;
-        taskAddedToQueueEvent.time = event.time;
-        taskAddedToQueueEvent.taskId = finishedTaskFromConnectedStation;
-        taskAddedToQueueEvent.stationId = event.stationId;
-        m_eventQueue.enqueue(taskAddedToQueueEvent);
+        m_traceEnded = true;
     }
+
+    scheduleEvent(Event(EventType::TaskEndedProcessing, getTimeAfter(serviceTime), stationId, taskId));
 }
 
-void Simulation::processTaskEndedProcessing(Event event)
+// Releases the first upstream task blocked on this station. Entries of tasks
+// which have meanwhile been released by another downstream station are
+// dropped on the way.
+void Simulation::processTaskQueueHasPlace(int stationId)
 {
-    WorkingStation& station = getWorkingStation(event.stationId);
+    BlockedTaskRegistry& registry = getWorkingStation(stationId).blockedUpstreamTasks;
 
-    for (int& processorTask : station.tasksInProcessors)
+    while (!registry.isEmpty())
     {
-        if (processorTask == event.taskId)
+        BlockedTaskRegistry::Entry entry = registry.head();
+        registry.pop();
+
+        WorkingStation& connectedStation = getWorkingStation(entry.stationId);
+        if (!connectedStation.blockedTasks.contains(entry.taskId)
+            || connectedStation.blockedTasks.value(entry.taskId) != entry.sequence)
         {
-            processorTask = -event.taskId;
-            break;
+            continue;
         }
+
+        connectedStation.blockedTasks.remove(entry.taskId);
+
+        scheduleTransition(EventType::MachineIsIdle, entry.stationId, entry.taskId);
+        scheduleTransition(EventType::TaskAddedToQueue, stationId, entry.taskId);
+        return;
     }
+}
 
-    QList<Connection> connections = getConnectionsFrom(event.stationId);
-    Connection connection = chooseConnectionToFollow(connections);
+void Simulation::processTaskEndedProcessing(int stationId, int taskId)
+{
+    WorkingStation& station = getWorkingStation(stationId);
+
+    station.tasksInProcessors.blockTask(taskId);
 
+    Connection connection = chooseConnectionToFollow(stationId);
     if (connection.from != INVALID_STATION_ID)
     {
-        Connection connection = chooseConnectionToFollow(connections);
-
-        Event taskMachineIsIdleEvent;
-        taskMachineIsIdleEvent.type = EventType::MachineIsIdle;
-        taskMachineIsIdleEvent.time = event.time;
-        taskMachineIsIdleEvent.taskId = event.taskId;
-        taskMachineIsIdleEvent.stationId = event.stationId;
-        m_eventQueue.enqueue(taskMachineIsIdleEvent);
+        scheduleTransition(EventType::MachineIsIdle, stationId, taskId);
 
         if (connection.to == OUTPUT_STATION_ID)
         {
-            Event taskOutputEvent;
-            taskOutputEvent.type = EventType::TaskOutput;
-            taskOutputEvent.time = event.time;
-            taskOutputEvent.taskId = event.taskId;
-            m_eventQueue.enqueue(taskOutputEvent);
+            scheduleTransition(EventType::TaskOutput, INVALID_STATION_ID, taskId);
         }
         else
         {
-            Event taskAddedToQueueEvent;
-            taskAddedToQueueEvent.type = EventType::TaskAddedToQueue;
-            taskAddedToQueueEvent.time = event.time;
-            taskAddedToQueueEvent.taskId = event.taskId;
-            taskAddedToQueueEvent.stationId = connection.to;
-            m_eventQueue.enqueue(taskAddedToQueueEvent);
+            scheduleTransition(EventType::TaskAddedToQueue, connection.to, taskId);
         }
     }
+    else
+    {
+        blockTask(stationId, taskId);
+    }
 }
 
-void Simulation::processTaskMachineIsIdle(Event event)
+void Simulation::processTaskMachineIsIdle(int stationId, int taskId)
 {
-    WorkingStation& station = getWorkingStation(event.stationId);
+    WorkingStation& station = getWorkingStation(stationId);
 
-    for (int& processorTask : station.tasksInProcessors)
-    {
-        if (processorTask == -event.taskId)
-        {
-            processorTask = EMPTY_TASK_ID;
-            break;
-        }
-    }
+    station.tasksInProcessors.releaseTask(taskId);
 
     int nextTaskToBeProcessed = EMPTY_TASK_ID;
     if (station.queueType == QueueType::Fifo)
     {
-        if (station.tasksInQueue.size() > 0)
+        if (!station.tasksInQueue.isEmpty())
         {
             nextTaskToBeProcessed = station.tasksInQueue.front();
         }
     }
     else if (station.queueType == QueueType::Random)
     {
-        nextTaskToBeProcessed = chooseRandomTaskFromQueue(station.tasksInQueue);
+        nextTaskToBeProcessed = chooseRandomTaskFromQueue(station);
     }
 
     if (nextTaskToBeProcessed == EMPTY_TASK_ID)
@@ -583,168 +1040,125 @@ void Simulation::processTaskMachineIsIdle(Event event)
         return;
     }
 
-    Event taskStartedProcessingEvent;
-    taskStartedProcessingEvent.type = EventType::TaskStartedProcessing;
-    taskStartedProcessingEvent.time = event.time;
-    taskStartedProcessingEvent.taskId = nextTaskToBeProcessed;
-    taskStartedProcessingEvent.stationId = event.stationId;
-    m_eventQueue.enqueue(taskStartedProcessingEvent);
+    scheduleTransition(EventType::TaskStartedProcessing, stationId, nextTaskToBeProcessed);
 }
 
-int Simulation::generateTaskId()
+// Registers a task which could not leave its station at every station it
+// could have gone to, the first of them to get place will take it
+void Simulation::blockTask(int stationId, int taskId)
 {
-    return m_nextTaskId++;
-}
+    quint64 sequence = m_nextBlockSequence++;
+    getWorkingStation(stationId).blockedTasks.insert(taskId, sequence);
 
-QList<Connection> Simulation::getConnectionsFrom(int stationId) const
-{
-    QList<Connection> connections;
-    for (const Connection& connection : m_instance.connections)
+    ConnectionGraph::Range connections = getConnectionsFrom(stationId);
+    for (const Connection& connection : connections)
     {
-        if (connection.from == stationId)
+        if (connection.to == OUTPUT_STATION_ID || connection.weight <= 0)
         {
-            connections.append(connection);
+            continue;
         }
+
+        BlockedTaskRegistry::Entry entry;
+        entry.taskId = taskId;
+        entry.stationId = stationId;
+        entry.priority = connection.weight;
+        entry.sequence = sequence;
+        getWorkingStation(connection.to).blockedUpstreamTasks.push(entry);
     }
-    return connections;
 }
 
-QList<Connection> Simulation::getConnectionsTo(int stationId) const
+// In tick time the delay is rounded to whole ticks and added in integer
+// arithmetic, so event times are reproducible bit for bit.
+double Simulation::getTimeAfter(double delay) const
 {
-    QList<Connection> connections;
-    for (const Connection& connection : m_instance.connections)
+    if (m_tickResolution.isEnabled())
     {
-        if (connection.to == stationId)
-        {
-            connections.append(connection);
-        }
+        return m_tickResolution.toTime(m_currentTicks + m_tickResolution.toTicks(delay));
     }
-    return connections;
+
+    return m_currentTime + delay;
+}
+
+int Simulation::generateTaskId()
+{
+    return m_nextTaskId++;
+}
+
+ConnectionGraph::Range Simulation::getConnectionsFrom(int stationId) const
+{
+    return m_instance.connectionGraph.getOutgoing(m_instance.getStationIndex(stationId));
+}
+
+ConnectionGraph::Range Simulation::getConnectionsTo(int stationId) const
+{
+    return m_instance.connectionGraph.getIncoming(m_instance.getStationIndex(stationId));
 }
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wreturn-type"
 Simulation::WorkingStation& Simulation::getWorkingStation(int stationId)
 {
-    for (WorkingStation& workingStation : m_instance.workingStations)
+    int index = m_instance.getStationIndex(stationId);
+    if (index >= 0)
     {
-        if (workingStation.id == stationId)
-        {
-            return workingStation;
-        }
+        return m_instance.workingStations[index];
     }
 
     qFatal("Station state for stationId=%d not found", stationId);
 }
 #pragma GCC diagnostic pop
 
-double Simulation::generateTime(const Distribution& distribution)
+// The sampler is rebuilt as well, variates it has buffered came from the
+// stream before it was reseeded
+void Simulation::seedRandomStreams(WorkingStation& station)
 {
-    double value = 1.0;
-
-    switch (distribution.type)
-    {
-        case DistributionType::Constant:
-        {
-            value = distribution.param1;
-            break;
-        }
-
-        case DistributionType::Uniform:
-        {
-            auto uniformDistribution = rnd::uniform_real_distribution<double>(distribution.param1, distribution.param2);
-            value = uniformDistribution(m_randomGenerator);
-            break;
-        }
-
-        case DistributionType::Normal:
-        {
-            auto normalDistribution = rnd::normal_distribution<double>(distribution.param1, distribution.param2);
-            value = normalDistribution(m_randomGenerator);
-            break;
-        }
-
-        case DistributionType::Exponential:
-        {
-            auto exponentialDistribution = rnd::exponential_distribution<double>(1.0 / distribution.param1);
-            value = exponentialDistribution(m_randomGenerator);
-            break;
-        }
-    }
-
-    return value;
+    station.serviceSampler = createSampler(station.serviceTimeDistribution);
+    seedRandomStream(station.serviceStream, RandomStreamType::Service, station.id);
+    seedRandomStream(station.routingStream, RandomStreamType::Routing, station.id);
+    seedRandomStream(station.queueSelectionStream, RandomStreamType::QueueSelection, station.id);
 }
 
-Connection Simulation::chooseConnectionToFollow(const QList<Connection>& connections)
+void Simulation::seedRandomStream(RandomStream& stream, RandomStreamType type, int stationId)
 {
-    QList<Connection> possibleConnections;
-    for (const Connection& connection : connections)
-    {
-        WorkingStation& connectedStation = getWorkingStation(connection.to);
-
-        bool hasPlace = true;
+    quint64 key = (static_cast<quint64>(type) << 32) | static_cast<quint32>(stationId);
+    stream.setGeneratorType(m_randomGeneratorType);
+    stream.setAntithetic(m_antithetic);
+    stream.seed(m_randomStreamSeeds.value(key, m_randomSeed), m_replication, type, stationId);
+}
 
-        if (connectedStation.queueLength > 0)
-        {
-            hasPlace = connectedStation.tasksInQueue.contains(EMPTY_TASK_ID);
-        }
+DistributionSampler Simulation::createSampler(const Distribution& distribution) const
+{
+    return DistributionSampler(distribution, m_samplingMethod);
+}
 
-        if (hasPlace)
-        {
-            possibleConnections.append(connection);
-        }
-    }
+Connection Simulation::chooseConnectionToFollow(int stationId)
+{
+    WorkingStation& station = getWorkingStation(stationId);
 
-    if (possibleConnections.isEmpty())
+    int totalWeightSum = station.routingSelector.getTotalWeight();
+    if (totalWeightSum <= 0)
     {
         return Connection();
     }
 
-    int totalWeightSum = 0;
-    for (const Connection& connection : possibleConnections)
-    {
-        totalWeightSum += connection.weight;
-    }
-
-    auto distribution = rnd::uniform_int_distribution<int>(0, totalWeightSum);
-    int randomWeightSum = distribution(m_randomGenerator);
-
-    int weightSum = 0;
-    int index = 0;
-    for (int i = 0; i < possibleConnections.size(); ++i)
-    {
-        weightSum += possibleConnections.at(i).weight;
-        if (weightSum >= randomWeightSum)
-        {
-            index = i;
-            break;
-        }
-    }
+    int randomWeightSum = station.routingStream.nextIndex(totalWeightSum);
 
-    return possibleConnections.at(index);
+    int index = station.routingSelector.find(randomWeightSum);
+    return getConnectionsFrom(stationId).at(index);
 }
 
-int Simulation::chooseRandomTaskFromQueue(const QList<int>& tasks)
+int Simulation::chooseRandomTaskFromQueue(WorkingStation& station)
 {
-    QList<int> nonEmptyTasks;
-    for (int taskId : tasks)
-    {
-        if (taskId != EMPTY_TASK_ID)
-        {
-            nonEmptyTasks.append(taskId);
-        }
-    }
-
-    if (nonEmptyTasks.isEmpty())
+    TaskQueue& tasks = station.tasksInQueue;
+    if (tasks.isEmpty())
     {
         return EMPTY_TASK_ID;
     }
 
-    auto distribution = rnd::uniform_int_distribution<int>(0, nonEmptyTasks.size() - 1);
-
-    int index = distribution(m_randomGenerator);
+    int index = station.queueSelectionStream.nextIndex(tasks.size());
+    tasks.moveToFront(index);
 
-    return nonEmptyTasks.at(index);
+    return tasks.front();
 }
 
 bool Simulation::check() const
@@ -772,7 +1186,8 @@ void Simulation::debugDump()
     qDebug() << "currentTime:" << m_currentTime;
     qDebug() << "eventQueue:";
 
-    QList<Event> allTasks = m_eventQueue.getAll();
+    QList<Event> allTasks = m_immediateEvents;
+    allTasks.append(m_eventQueue->getAll());
     for (const Event& event : allTasks)
     {
         qDebug() << " time:" << event.time << ", type:" << event.type << ", stationId:" << event.stationId << ", taskId:" << event.taskId;
@@ -786,6 +1201,6 @@ void Simulation::debugDump()
             continue;
         }
 
-        qDebug() << " stationId:" << station.id << ",tasksInQueue:" << station.tasksInQueue << ",tasksInProcessors:" << station.tasksInProcessors;
+        qDebug() << " stationId:" << station.id << ",tasksInQueue:" << station.tasksInQueue.toList() << ",tasksInProcessors:" << station.tasksInProcessors.toList();
     }
 }
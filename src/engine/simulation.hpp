@@ -1,13 +1,26 @@
 #pragma once
 
+#include "engine/arrival_source_heap.hpp"
+#include "engine/blocked_task_registry.hpp"
+#include "engine/connection_graph.hpp"
+#include "engine/distribution_sampler.hpp"
 #include "engine/event.hpp"
+#include "engine/event_listener.hpp"
 #include "engine/event_priority_queue.hpp"
+#include "engine/processor_pool.hpp"
+#include "engine/random_stream.hpp"
 #include "engine/simulation_instance.hpp"
+#include "engine/stop_condition.hpp"
+#include "engine/task_queue.hpp"
+#include "engine/tick_time.hpp"
+#include "engine/weighted_selector.hpp"
 
+#include <QHash>
 #include <QList>
 #include <QQueue>
+#include <QVector>
 
-#include <boost/random.hpp>
+#include <memory>
 
 class Simulation
 {
@@ -17,9 +30,43 @@ private:
         WorkingStation(const Station& station);
 
         void resetStateParams();
+        bool hasPlaceInQueue() const;
 
-        QList<int> tasksInQueue;
-        QList<int> tasksInProcessors;
+        TaskQueue tasksInQueue;
+        ProcessorPool tasksInProcessors;
+
+        // Tasks of this station which are blocked on full downstream queues,
+        // with the sequence number they were registered under
+        QHash<int, quint64> blockedTasks;
+
+        // Tasks of upstream stations waiting for place in this one's queue
+        BlockedTaskRegistry blockedUpstreamTasks;
+
+        // Outgoing connections weighted by whether their target has place
+        WeightedSelector routingSelector;
+
+        DistributionSampler serviceSampler;
+        RandomStream serviceStream;
+        RandomStream routingStream;
+        RandomStream queueSelectionStream;
+    };
+
+    // Sampler and stream of an arrival source. The input station's source
+    // always comes first, followed by the instance's arrival sources.
+    struct WorkingArrivalSource
+    {
+        int stationId;
+        DistributionSampler sampler;
+        RandomStream stream;
+    };
+
+    // Zero-time transition noted down in fused mode, it happens at the
+    // current time
+    struct Transition
+    {
+        EventType type;
+        int stationId;
+        int taskId;
     };
 
     struct WorkingInstance
@@ -29,23 +76,74 @@ private:
         WorkingInstance& operator=(const SimulationInstance& simulationInstance);
 
         void setStations(const QList<Station>& stations);
+        void rebuildIndices();
+        void rebuildRouting();
+        void updateRouting(int stationIndex);
+        int getStationIndex(int stationId) const;
 
         SimulationInstance toSimulationInstance() const;
 
         Distribution arrivalTimeDistribution;
         QList<WorkingStation> workingStations;
         QList<Connection> connections;
+        QList<ArrivalSource> arrivalSources;
+
+        // Index into workingStations for each station id, shifted by
+        // OUTPUT_STATION_ID so that all valid ids are non-negative
+        QVector<int> stationIndices;
+        ConnectionGraph connectionGraph;
     };
 
 public:
     Simulation();
 
+    void setEventQueueType(EventQueueType type);
+    EventQueueType getEventQueueType() const;
+
+    void setTickResolution(double ticksPerTimeUnit);
+    double getTickResolution() const;
+
+    void setFusedTransitions(bool fused);
+    bool getFusedTransitions() const;
+
+    void setUnblockingPolicy(UnblockingPolicy policy);
+    UnblockingPolicy getUnblockingPolicy() const;
+
+    // Sets the base seed and the replication number all random streams are
+    // derived from, runs with different replication numbers are independent.
+    // Streams are reseeded on reset.
+    void setRandomSeed(quint64 seed, quint64 replication = 0);
+    quint64 getRandomSeed() const;
+    quint64 getReplication() const;
+
+    // Replaces the base seed for a single stream, e.g. to vary the service
+    // times of one station while keeping all other draws the same. Arrival
+    // streams of arrival sources are identified by the source's position.
+    void setRandomStreamSeed(RandomStreamType type, int stationId, quint64 seed);
+    void clearRandomStreamSeeds();
+
+    void setRandomGeneratorType(RandomGeneratorType type);
+    RandomGeneratorType getRandomGeneratorType() const;
+
+    void setSamplingMethod(SamplingMethod method);
+    SamplingMethod getSamplingMethod() const;
+
+    // Makes every stream return 1 - U instead of U from the next reset on.
+    // A run and its antithetic twin, both with the same seed and inverse
+    // transform sampling, give negatively correlated results.
+    void setAntithetic(bool antithetic);
+    bool isAntithetic() const;
+
+    void addEventListener(EventListener* listener);
+    void removeEventListener(EventListener* listener);
+
     void setInstance(const SimulationInstance& instance);
     SimulationInstance getInstance() const;
 
     void addStation(const Station& station);
     void addConnection(const Connection& connection);
 
+    Distribution getArrivalDistribution() const;
     void changeArrivalDistribution(const Distribution& distribution);
 
     int getNextStationId() const;
@@ -65,8 +163,18 @@ public:
 
     void reset();
     Event simulateNextStep();
-    double getCurrentTime();
+    double getCurrentTime() const;
     double getTimeToNextStep();
+    bool hasPendingEvents() const;
+    bool isTraceEnded() const;
+
+    StopReason run(const StopCondition& condition);
+    StopReason runUntil(double time);
+    StopReason runEvents(quint64 count);
+    StopReason runUntilCompletedTasks(quint64 count);
+
+    quint64 getProcessedEventCount() const;
+    quint64 getCompletedTaskCount() const;
 
     bool check() const;
     static bool check(const SimulationInstance& instance);
@@ -77,28 +185,63 @@ public:
     void debugDump();
 
 private:
+    void scheduleEvent(const Event& event);
+    void scheduleTransition(EventType type, int stationId, int taskId);
+    bool isImmediateEventNext();
+    Event dequeueNextEvent();
     void processEvent(Event event);
-    void processTaskInput(Event event);
-    void processTaskAddedToQueue(Event event);
-    void processTaskStartedProcessing(Event event);
-    void processTaskEndedProcessing(Event event);
-    void processTaskQueueHasPlace(Event event);
-    void processTaskMachineIsIdle(Event event);
+    void dispatchEvent(const Event& event);
+    void runTransition(EventType type, int stationId, int taskId);
+    void processTaskInput(int taskId);
+    void processTaskAddedToQueue(int stationId, int taskId);
+    void processTaskStartedProcessing(int stationId, int taskId);
+    void processTaskEndedProcessing(int stationId, int taskId);
+    void processTaskQueueHasPlace(int stationId);
+    void processTaskMachineIsIdle(int stationId, int taskId);
+    void blockTask(int stationId, int taskId);
+
+    void rebuildEventQueue(EventQueueType type);
+    void advanceTimeTo(double time);
+    double getTimeAfter(double delay) const;
 
     int generateTaskId();
-    QList<Connection> getConnectionsFrom(int stationId) const;
-    QList<Connection> getConnectionsTo(int stationId) const;
+    ConnectionGraph::Range getConnectionsFrom(int stationId) const;
+    ConnectionGraph::Range getConnectionsTo(int stationId) const;
     WorkingStation& getWorkingStation(int stationId);
 
-    double generateTime(const Distribution& distribution);
-    Connection chooseConnectionToFollow(const QList<Connection>& connections);
-    int chooseRandomTaskFromQueue(const QList<int>& tasks);
+    void resetArrivalSources();
+    Event createArrivalEvent();
+
+    void seedRandomStreams(WorkingStation& station);
+    DistributionSampler createSampler(const Distribution& distribution) const;
+    void seedRandomStream(RandomStream& stream, RandomStreamType type, int stationId);
+
+    Connection chooseConnectionToFollow(int stationId);
+    int chooseRandomTaskFromQueue(WorkingStation& station);
 
 private:
     WorkingInstance m_instance;
-    EventPriorityQueue m_eventQueue;
+    std::unique_ptr<EventPriorityQueue> m_eventQueue;
+    QQueue<Event> m_immediateEvents;
+    QVector<Transition> m_transitions;
+    QList<EventListener*> m_eventListeners;
+    bool m_fusedTransitions;
+    UnblockingPolicy m_unblockingPolicy;
+    quint64 m_nextBlockSequence;
     int m_nextStationId;
     int m_nextTaskId;
     double m_currentTime;
-    boost::random::mt19937 m_randomGenerator;
+    TickResolution m_tickResolution;
+    qint64 m_currentTicks;
+    quint64 m_processedEventCount;
+    quint64 m_completedTaskCount;
+    bool m_traceEnded;
+    quint64 m_randomSeed;
+    quint64 m_replication;
+    QHash<quint64, quint64> m_randomStreamSeeds;
+    RandomGeneratorType m_randomGeneratorType;
+    SamplingMethod m_samplingMethod;
+    bool m_antithetic;
+    QVector<WorkingArrivalSource> m_arrivalSources;
+    ArrivalSourceHeap m_arrivalSourceHeap;
 };
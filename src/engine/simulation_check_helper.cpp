@@ -1,5 +1,7 @@
 #include "engine/simulation_check_helper.hpp"
 
+#include "engine/distribution_sampler.hpp"
+
 #include <QDebug>
 #include <QSet>
 #include <QStack>
@@ -21,6 +23,12 @@ bool SimulationCheckHelper::check(const SimulationInstance& instance)
         if (station.id == INPUT_STATION_ID)
         {
             ++numberOfInputs;
+
+            if (!DistributionSampler::isValid(instance.arrivalTimeDistribution))
+            {
+                qDebug() << "Check: invalid arrival time distribution";
+                return false;
+            }
         }
         else if (station.id == OUTPUT_STATION_ID)
         {
@@ -37,6 +45,18 @@ bool SimulationCheckHelper::check(const SimulationInstance& instance)
             {
                 qDebug() << "Check: invalid number of processors";
             }
+
+            if (!DistributionSampler::isValid(station.serviceTimeDistribution))
+            {
+                qDebug() << "Check: invalid service time distribution";
+                return false;
+            }
+
+            if (DistributionSampler::isArrivalProcess(station.serviceTimeDistribution.type))
+            {
+                qDebug() << "Check: arrival process as service time distribution";
+                return false;
+            }
         }
 
         stationIds.insert(station.id);
@@ -48,12 +68,33 @@ bool SimulationCheckHelper::check(const SimulationInstance& instance)
         return false;
     }
 
-    if (numberOfInputs != 1)
+    // Tasks may come through the input station, straight from arrival
+    // sources or both
+    if (numberOfInputs > 1 || numberOfInputs + instance.arrivalSources.size() == 0)
     {
         qDebug() << "Check: invalid number of inputs";
         return false;
     }
 
+    QSet<int> entryStationIds;
+    for (const ArrivalSource& arrivalSource : instance.arrivalSources)
+    {
+        if (!stationIds.contains(arrivalSource.stationId) || arrivalSource.stationId == INPUT_STATION_ID
+            || arrivalSource.stationId == OUTPUT_STATION_ID)
+        {
+            qDebug() << "Check: invalid arrival source station id";
+            return false;
+        }
+
+        if (!DistributionSampler::isValid(arrivalSource.arrivalTimeDistribution))
+        {
+            qDebug() << "Check: invalid arrival source distribution";
+            return false;
+        }
+
+        entryStationIds.insert(arrivalSource.stationId);
+    }
+
     if (numberOfOutputs != 1)
     {
         qDebug() << "Check: invalid number of outputs";
@@ -126,7 +167,8 @@ bool SimulationCheckHelper::check(const SimulationInstance& instance)
         }
         else
         {
-            if (numberOfIncomingConnections == 0 || numberOfOutgoingConnections == 0)
+            bool hasArrivals = numberOfIncomingConnections > 0 || entryStationIds.contains(station.id);
+            if (!hasArrivals || numberOfOutgoingConnections == 0)
             {
                 qDebug() << "Check: invalid number of connections for station";
                 return false;
@@ -134,11 +176,20 @@ bool SimulationCheckHelper::check(const SimulationInstance& instance)
         }
     }
 
-    bool hasCycle = checkForCycles(instance.connections, INPUT_STATION_ID);
-    if (hasCycle)
+    QSet<int> startStationIds = entryStationIds;
+    if (numberOfInputs > 0)
     {
-        qDebug() << "Check: cycle detected";
-        return false;
+        startStationIds.insert(INPUT_STATION_ID);
+    }
+
+    for (int startStationId : startStationIds)
+    {
+        bool hasCycle = checkForCycles(instance.connections, startStationId);
+        if (hasCycle)
+        {
+            qDebug() << "Check: cycle detected";
+            return false;
+        }
     }
 
     qDebug() << "Check: ok";
@@ -1,19 +1,29 @@
 #include "engine/simulation_input_output_helper.hpp"
 
+#include "engine/distribution_sampler.hpp"
+#include "engine/empirical_table.hpp"
+#include "engine/trace_file.hpp"
+
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 #include <boost/concept_check.hpp>
 
 struct ParseContext
 {
-    ParseContext(SimulationInstance& instance)
-     : simulationInstance(instance) {}
+    ParseContext(SimulationInstance& instance, const QDir& directory)
+     : simulationInstance(instance)
+     , directory(directory) {}
 
     QString line;
     int lineNumber = 0;
     int stationsCount = 0;
     int stationId = 0;
     SimulationInstance& simulationInstance;
+
+    // Directory of the model file, which table paths are relative to
+    QDir directory;
 };
 
 
@@ -26,7 +36,7 @@ SimulationInstance SimulationInputOutputHelper::readFromFile(const QString& path
     {
         QTextStream in(&file);
 
-        ParseContext context(simulationInstance);
+        ParseContext context(simulationInstance, QFileInfo(path).absoluteDir());
         context.line = in.readLine();
 
         while (!context.line.isNull())
@@ -53,12 +63,21 @@ bool SimulationInputOutputHelper::parseLine(ParseContext& context)
     else if (context.lineNumber <= context.stationsCount + 1)
     {
         Station station;
-        result = parseStation(context.line, station, context.stationId);
+        result = parseStation(context, station);
         if (result)
         {
             context.simulationInstance.stations.append(station);
         }
     }
+    else if (context.line.startsWith("SRC,"))
+    {
+        ArrivalSource arrivalSource;
+        result = parseArrivalSource(context, arrivalSource);
+        if (result)
+        {
+            context.simulationInstance.arrivalSources.append(arrivalSource);
+        }
+    }
     else
     {
         Connection connection;
@@ -80,7 +99,7 @@ bool SimulationInputOutputHelper::parseFirstLine(ParseContext& context)
         return false;
     }
 
-    if (!parseDistribution(components[0], context.simulationInstance.arrivalTimeDistribution))
+    if (!parseDistribution(components[0], context.directory, context.simulationInstance.arrivalTimeDistribution))
     {
         return false;
     }
@@ -91,9 +110,9 @@ bool SimulationInputOutputHelper::parseFirstLine(ParseContext& context)
     return ok;
 }
 
-bool SimulationInputOutputHelper::parseStation(const QString& line, Station& station, int& stationId)
+bool SimulationInputOutputHelper::parseStation(ParseContext& context, Station& station)
 {
-    QStringList components = line.split(",");
+    QStringList components = context.line.split(",");
     if (components.size() != 3 && components.size() != 6)
     {
         return false;
@@ -116,9 +135,9 @@ bool SimulationInputOutputHelper::parseStation(const QString& line, Station& sta
     }
     else
     {
-        station.id = ++stationId;
+        station.id = ++context.stationId;
 
-        if (!parseDistribution(components[0], station.serviceTimeDistribution))
+        if (!parseDistribution(components[0], context.directory, station.serviceTimeDistribution))
         {
             return false;
         }
@@ -217,7 +236,27 @@ bool SimulationInputOutputHelper::parseConnection(const QString& line, Connectio
     return true;
 }
 
-bool SimulationInputOutputHelper::parseDistribution(const QString& str, Distribution& distribution)
+// "SRC,station id,arrival time distribution"
+bool SimulationInputOutputHelper::parseArrivalSource(ParseContext& context, ArrivalSource& arrivalSource)
+{
+    QStringList components = context.line.split(",");
+    if (components.size() != 3)
+    {
+        return false;
+    }
+
+    bool ok = false;
+    arrivalSource.stationId = components[1].toInt(&ok);
+    if (!ok)
+    {
+        return false;
+    }
+
+    return parseDistribution(components[2], context.directory, arrivalSource.arrivalTimeDistribution);
+}
+
+bool SimulationInputOutputHelper::parseDistribution(const QString& str, const QDir& directory,
+                                                    Distribution& distribution)
 {
     if (str.isEmpty())
     {
@@ -235,7 +274,7 @@ bool SimulationInputOutputHelper::parseDistribution(const QString& str, Distribu
         }
 
         bool ok = false;
-        distribution.param1 = components[0].toFloat(&ok);
+        distribution.param1 = components[0].toDouble(&ok);
         if (!ok)
         {
             return false;
@@ -243,7 +282,7 @@ bool SimulationInputOutputHelper::parseDistribution(const QString& str, Distribu
 
         if (numberOfParams > 1)
         {
-            distribution.param2 = components[1].toFloat(&ok);
+            distribution.param2 = components[1].toDouble(&ok);
             if (!ok)
             {
                 return false;
@@ -253,33 +292,126 @@ bool SimulationInputOutputHelper::parseDistribution(const QString& str, Distribu
         return true;
     };
 
+    auto parseParamList = [&distribution,&components](int firstComponent) -> bool
+    {
+        distribution.params.clear();
+        for (int i = firstComponent; i < components.size(); ++i)
+        {
+            bool ok = false;
+            distribution.params.append(components[i].toDouble(&ok));
+            if (!ok)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    bool result = false;
     switch (letter.toLatin1())
     {
         case 'C':
             distribution.type = DistributionType::Constant;
-            parseParams(1);
+            result = parseParams(1);
             break;
 
         case 'U':
-            distribution.type = DistributionType::Constant;
-            parseParams(2);
+            distribution.type = DistributionType::Uniform;
+            result = parseParams(2);
             break;
 
         case 'E':
             distribution.type = DistributionType::Exponential;
-            parseParams(1);
+            result = parseParams(1);
             break;
 
         case 'N':
             distribution.type = DistributionType::Normal;
-            parseParams(2);
+            result = parseParams(2);
+            break;
+
+        case 'L':
+            distribution.type = DistributionType::Lognormal;
+            result = parseParams(2);
+            break;
+
+        case 'G':
+            distribution.type = DistributionType::Gamma;
+            result = parseParams(2);
+            break;
+
+        case 'K':
+            distribution.type = DistributionType::Erlang;
+            result = parseParams(2);
+            break;
+
+        case 'W':
+            distribution.type = DistributionType::Weibull;
+            result = parseParams(2);
+            break;
+
+        case 'H':
+            distribution.type = DistributionType::HyperExponential;
+            result = parseParamList(0);
+            break;
+
+        case 'P':
+        case 'M':
+        case 'A':
+        {
+            distribution.type = letter.toLatin1() == 'P' ? DistributionType::PhaseType
+                                : letter.toLatin1() == 'M' ? DistributionType::MarkovModulatedPoisson
+                                : DistributionType::MarkovianArrival;
+            bool ok = false;
+            distribution.param1 = components[0].toDouble(&ok);
+            result = ok && parseParamList(1);
+            break;
+        }
+
+        case 'R':
+        {
+            // "Rstep_..." or "Rlinear_..." followed by pairs of time and rate
+            if (components[0] != "step" && components[0] != "linear")
+            {
+                break;
+            }
+
+            distribution.type = DistributionType::NonHomogeneousPoisson;
+            distribution.param1 = components[0] == "linear" ? 1.0 : 0.0;
+            result = parseParamList(1);
+            break;
+        }
+
+        case 'T':
+            distribution.type = DistributionType::Empirical;
+            distribution.table = EmpiricalTable::load(directory.absoluteFilePath(str.mid(1)));
+            result = true;
             break;
 
+        case 'D':
+        {
+            // "Dloop:path" replays the trace again after its end, "Dstop:path"
+            // ends the arrivals or the run
+            int separator = str.indexOf(':');
+            QString mode = str.mid(1, separator - 1);
+            if (separator < 0 || (mode != "loop" && mode != "stop"))
+            {
+                break;
+            }
+
+            distribution.type = DistributionType::Trace;
+            distribution.param1 = mode == "loop" ? 1.0 : 0.0;
+            distribution.trace = TraceFile::open(directory.absoluteFilePath(str.mid(separator + 1)));
+            result = true;
+            break;
+        }
+
         default:
             break;
     }
 
-    return true;
+    return result && DistributionSampler::isValid(distribution);
 }
 
 void SimulationInputOutputHelper::saveToFile(const QString& path, const SimulationInstance& simulationInstance)
@@ -291,31 +423,51 @@ void SimulationInputOutputHelper::saveToFile(const QString& path, const Simulati
     }
 
     QTextStream out(&file);
+    QDir directory = QFileInfo(path).absoluteDir();
 
-    saveFirstLine(out, simulationInstance);
+    saveFirstLine(out, directory, simulationInstance);
 
     for (const Station& station : simulationInstance.stations)
     {
-        saveStation(out, station);
+        saveStation(out, directory, station);
     }
 
     for (const Connection& connection : simulationInstance.connections)
     {
         saveConnection(out, connection);
     }
+
+    for (const ArrivalSource& arrivalSource : simulationInstance.arrivalSources)
+    {
+        saveArrivalSource(out, directory, arrivalSource);
+    }
 }
 
-QString SimulationInputOutputHelper::distributionToString(const Distribution& distribution)
+QString SimulationInputOutputHelper::distributionToString(const Distribution& distribution, const QDir& directory)
 {
     QString str;
     QTextStream out(&str);
 
+    // Full precision, rounded probabilities and rates would fail the
+    // validity check on reload
     auto printParams = [&out,&distribution](int numberOfParams)
     {
-        out << distribution.param1;
+        out << QString::number(distribution.param1, 'g', 17);
         if (numberOfParams > 1)
         {
-            out << '_' << distribution.param2;
+            out << '_' << QString::number(distribution.param2, 'g', 17);
+        }
+    };
+
+    auto printParamList = [&out,&distribution](bool separatorFirst)
+    {
+        for (int i = 0; i < distribution.params.size(); ++i)
+        {
+            if (i > 0 || separatorFirst)
+            {
+                out << '_';
+            }
+            out << QString::number(distribution.params.at(i), 'g', 17);
         }
     };
 
@@ -340,20 +492,85 @@ QString SimulationInputOutputHelper::distributionToString(const Distribution& di
             out << 'N';
             printParams(2);
             break;
+
+        case DistributionType::Lognormal:
+            out << 'L';
+            printParams(2);
+            break;
+
+        case DistributionType::Gamma:
+            out << 'G';
+            printParams(2);
+            break;
+
+        case DistributionType::Erlang:
+            out << 'K';
+            printParams(2);
+            break;
+
+        case DistributionType::Weibull:
+            out << 'W';
+            printParams(2);
+            break;
+
+        case DistributionType::HyperExponential:
+            out << 'H';
+            printParamList(false);
+            break;
+
+        case DistributionType::PhaseType:
+            out << 'P';
+            printParams(1);
+            printParamList(true);
+            break;
+
+        case DistributionType::MarkovModulatedPoisson:
+            out << 'M';
+            printParams(1);
+            printParamList(true);
+            break;
+
+        case DistributionType::MarkovianArrival:
+            out << 'A';
+            printParams(1);
+            printParamList(true);
+            break;
+
+        case DistributionType::NonHomogeneousPoisson:
+            out << 'R' << (distribution.param1 != 0.0 ? "linear" : "step");
+            printParamList(true);
+            break;
+
+        case DistributionType::Empirical:
+            out << 'T';
+            if (!distribution.table.isNull())
+            {
+                out << directory.relativeFilePath(distribution.table->getPath());
+            }
+            break;
+
+        case DistributionType::Trace:
+            out << 'D' << (distribution.param1 != 0.0 ? "loop" : "stop") << ':';
+            if (!distribution.trace.isNull())
+            {
+                out << directory.relativeFilePath(distribution.trace->getPath());
+            }
+            break;
     }
 
     return str;
 }
 
-void SimulationInputOutputHelper::saveFirstLine(QTextStream& out, const SimulationInstance& simulationInstance)
+void SimulationInputOutputHelper::saveFirstLine(QTextStream& out, const QDir& directory,
+                                                const SimulationInstance& simulationInstance)
 {
-    out << distributionToString(simulationInstance.arrivalTimeDistribution);
+    out << distributionToString(simulationInstance.arrivalTimeDistribution, directory);
     out << ",";
     out << simulationInstance.stations.size();
     out << "\n";
 }
 
-void SimulationInputOutputHelper::saveStation(QTextStream& out, const Station& station)
+void SimulationInputOutputHelper::saveStation(QTextStream& out, const QDir& directory, const Station& station)
 {
     if (station.id == INPUT_STATION_ID)
     {
@@ -365,7 +582,7 @@ void SimulationInputOutputHelper::saveStation(QTextStream& out, const Station& s
     }
     else
     {
-        out << distributionToString(station.serviceTimeDistribution);
+        out << distributionToString(station.serviceTimeDistribution, directory);
         out << ",";
         out << station.processorCount;
         out << ",";
@@ -414,3 +631,13 @@ void SimulationInputOutputHelper::saveConnection(QTextStream& out, const Connect
     out << connection.weight;
     out << "\n";
 }
+
+void SimulationInputOutputHelper::saveArrivalSource(QTextStream& out, const QDir& directory,
+                                                    const ArrivalSource& arrivalSource)
+{
+    out << "SRC,";
+    out << arrivalSource.stationId;
+    out << ",";
+    out << distributionToString(arrivalSource.arrivalTimeDistribution, directory);
+    out << "\n";
+}
@@ -5,6 +5,7 @@
 #include <QString>
 
 struct ParseContext;
+class QDir;
 class QTextStream;
 
 class SimulationInputOutputHelper
@@ -16,12 +17,14 @@ public:
 private:
     static bool parseLine(ParseContext& context);
     static bool parseFirstLine(ParseContext& context);
-    static bool parseStation(const QString& line, Station& station, int& stationId);
+    static bool parseStation(ParseContext& context, Station& station);
     static bool parseConnection(const QString& line, Connection& connection);
-    static bool parseDistribution(const QString& str, Distribution& distribution);
+    static bool parseArrivalSource(ParseContext& context, ArrivalSource& arrivalSource);
+    static bool parseDistribution(const QString& str, const QDir& directory, Distribution& distribution);
 
-    static QString distributionToString(const Distribution& distribution);
-    static void saveFirstLine(QTextStream& out, const SimulationInstance& simulationInstance);
-    static void saveStation(QTextStream& out, const Station& station);
+    static QString distributionToString(const Distribution& distribution, const QDir& directory);
+    static void saveFirstLine(QTextStream& out, const QDir& directory, const SimulationInstance& simulationInstance);
+    static void saveStation(QTextStream& out, const QDir& directory, const Station& station);
     static void saveConnection(QTextStream& out, const Connection& connection);
+    static void saveArrivalSource(QTextStream& out, const QDir& directory, const ArrivalSource& arrivalSource);
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "engine/arrival_source.hpp"
 #include "engine/connection.hpp"
 #include "engine/distribution.hpp"
 #include "engine/station.hpp"
@@ -11,4 +12,5 @@ struct SimulationInstance
     Distribution arrivalTimeDistribution;
     QList<Station> stations;
     QList<Connection> connections;
+    QList<ArrivalSource> arrivalSources;
 };
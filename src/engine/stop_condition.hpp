@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <functional>
+#include <limits>
+
+class Simulation;
+
+enum class StopReason
+{
+    TimeLimit,
+    EventLimit,
+    CompletedTaskLimit,
+    Predicate,
+    NoEvents,
+    TraceEnd
+};
+
+// When Simulation::run() should return. Whichever limit is reached first
+// stops the run; event and completed task limits are counted from the start
+// of the run, a limit of zero returns at once. The predicate, if set, is
+// checked before every event.
+struct StopCondition
+{
+    double timeLimit;
+    quint64 eventLimit;
+    quint64 completedTaskLimit;
+    std::function<bool(const Simulation&)> predicate;
+
+    StopCondition()
+     : timeLimit(std::numeric_limits<double>::infinity())
+     , eventLimit(std::numeric_limits<quint64>::max())
+     , completedTaskLimit(std::numeric_limits<quint64>::max())
+    {}
+};
@@ -0,0 +1,151 @@
+#include "engine/task_queue.hpp"
+
+#include "engine/event.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    const int INITIAL_UNBOUNDED_SLOTS = 16;
+}
+
+
+TaskQueue::TaskQueue()
+ : m_head(0)
+ , m_size(0)
+ , m_capacity(0)
+{}
+
+void TaskQueue::reset(int capacity)
+{
+    m_capacity = capacity;
+    m_head = 0;
+    m_size = 0;
+    m_slots.fill(EMPTY_TASK_ID, capacity > 0 ? capacity : INITIAL_UNBOUNDED_SLOTS);
+}
+
+bool TaskQueue::isEmpty() const
+{
+    return m_size == 0;
+}
+
+bool TaskQueue::isFull() const
+{
+    return m_capacity > 0 && m_size >= m_capacity;
+}
+
+int TaskQueue::size() const
+{
+    return m_size;
+}
+
+int TaskQueue::at(int index) const
+{
+    return m_slots.at(getSlot(index));
+}
+
+int TaskQueue::front() const
+{
+    return m_slots.at(m_head);
+}
+
+void TaskQueue::push(int taskId)
+{
+    if (m_size == m_slots.size())
+    {
+        grow();
+    }
+
+    m_slots[getSlot(m_size)] = taskId;
+    ++m_size;
+}
+
+int TaskQueue::popFront()
+{
+    int taskId = m_slots.at(m_head);
+    m_slots[m_head] = EMPTY_TASK_ID;
+
+    m_head = getSlot(1);
+    --m_size;
+
+    return taskId;
+}
+
+// O(1) when the task is at either end, which is the case for FIFO queues
+// and for tasks moved to the front with moveToFront()
+bool TaskQueue::remove(int taskId)
+{
+    if (m_size == 0)
+    {
+        return false;
+    }
+
+    if (front() == taskId)
+    {
+        popFront();
+        return true;
+    }
+
+    int lastSlot = getSlot(m_size - 1);
+    if (m_slots.at(lastSlot) == taskId)
+    {
+        m_slots[lastSlot] = EMPTY_TASK_ID;
+        --m_size;
+        return true;
+    }
+
+    for (int i = 1; i < m_size - 1; ++i)
+    {
+        if (at(i) == taskId)
+        {
+            for (int j = i; j < m_size - 1; ++j)
+            {
+                m_slots[getSlot(j)] = at(j + 1);
+            }
+
+            m_slots[lastSlot] = EMPTY_TASK_ID;
+            --m_size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskQueue::moveToFront(int index)
+{
+    int slot = getSlot(index);
+    std::swap(m_slots[m_head], m_slots[slot]);
+}
+
+QList<int> TaskQueue::toList() const
+{
+    QList<int> tasks;
+    for (int i = 0; i < m_size; ++i)
+    {
+        tasks.append(at(i));
+    }
+    return tasks;
+}
+
+int TaskQueue::getSlot(int index) const
+{
+    int slot = m_head + index;
+    if (slot >= m_slots.size())
+    {
+        slot -= m_slots.size();
+    }
+    return slot;
+}
+
+void TaskQueue::grow()
+{
+    QVector<int> slots(m_slots.size() * 2, EMPTY_TASK_ID);
+    for (int i = 0; i < m_size; ++i)
+    {
+        slots[i] = at(i);
+    }
+
+    m_slots.swap(slots);
+    m_head = 0;
+}
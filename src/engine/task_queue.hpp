@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QList>
+#include <QVector>
+
+
+// Queue of task ids waiting at a station, kept in a ring buffer. A queue
+// with zero capacity is unbounded and grows as needed.
+class TaskQueue
+{
+public:
+    TaskQueue();
+
+    void reset(int capacity);
+
+    bool isEmpty() const;
+    bool isFull() const;
+    int size() const;
+
+    int at(int index) const;
+    int front() const;
+
+    void push(int taskId);
+    int popFront();
+    bool remove(int taskId);
+
+    // Swaps the task at the given position with the front one, so that it
+    // can be taken out in O(1); only for queues whose order does not matter
+    void moveToFront(int index);
+
+    QList<int> toList() const;
+
+private:
+    int getSlot(int index) const;
+    void grow();
+
+private:
+    QVector<int> m_slots;
+    int m_head;
+    int m_size;
+    int m_capacity;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <cmath>
+
+const double DEFAULT_TICKS_PER_TIME_UNIT = 1000000.0;
+
+// Fixed-point representation of simulation time as an integer number of
+// ticks, each lasting 1/ticksPerTimeUnit time units. A resolution of zero
+// means that simulation time is continuous.
+struct TickResolution
+{
+    double ticksPerTimeUnit;
+
+    TickResolution()
+     : ticksPerTimeUnit(0.0)
+    {}
+
+    explicit TickResolution(double ticksPerTimeUnit)
+     : ticksPerTimeUnit(ticksPerTimeUnit)
+    {}
+
+    bool isEnabled() const
+    {
+        return ticksPerTimeUnit > 0.0;
+    }
+
+    qint64 toTicks(double time) const
+    {
+        return static_cast<qint64>(std::llround(time * ticksPerTimeUnit));
+    }
+
+    double toTime(qint64 ticks) const
+    {
+        return ticks / ticksPerTimeUnit;
+    }
+};
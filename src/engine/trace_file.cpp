@@ -0,0 +1,186 @@
+#include "engine/trace_file.hpp"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWeakPointer>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    QMutex cacheMutex;
+    QHash<QString, QWeakPointer<const TraceFile>> cache;
+
+    double fromLittleEndian(const uchar* data)
+    {
+        quint64 bits = qFromLittleEndian<quint64>(data);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    bool isLittleEndianHost()
+    {
+        return Q_BYTE_ORDER == Q_LITTLE_ENDIAN;
+    }
+}
+
+
+const quint32 TraceFile::MAGIC = 0x43525451;
+const quint32 TraceFile::VERSION = 1;
+const int TraceFile::HEADER_SIZE = 16;
+
+TraceFile::TraceFile()
+ : m_data(nullptr)
+ , m_count(0)
+{}
+
+TraceFile::~TraceFile()
+{
+    if (m_data != nullptr)
+    {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+QSharedPointer<const TraceFile> TraceFile::open(const QString& path)
+{
+    QString absolutePath = QFileInfo(path).absoluteFilePath();
+
+    QMutexLocker locker(&cacheMutex);
+
+    QSharedPointer<const TraceFile> cached = cache.value(absolutePath).toStrongRef();
+    if (!cached.isNull())
+    {
+        return cached;
+    }
+
+    QSharedPointer<TraceFile> trace(new TraceFile());
+    trace->m_file.setFileName(absolutePath);
+    if (!trace->m_file.open(QIODevice::ReadOnly) || trace->m_file.size() < HEADER_SIZE)
+    {
+        return QSharedPointer<const TraceFile>();
+    }
+
+    qint64 fileSize = trace->m_file.size();
+    trace->m_data = trace->m_file.map(0, fileSize);
+    if (trace->m_data == nullptr)
+    {
+        return QSharedPointer<const TraceFile>();
+    }
+
+    const uchar* data = trace->m_data;
+    quint64 count = qFromLittleEndian<quint64>(data + 8);
+    if (qFromLittleEndian<quint32>(data) != MAGIC || qFromLittleEndian<quint32>(data + 4) != VERSION
+        || count != static_cast<quint64>(fileSize - HEADER_SIZE) / sizeof(double)
+        || (fileSize - HEADER_SIZE) % sizeof(double) != 0)
+    {
+        return QSharedPointer<const TraceFile>();
+    }
+    trace->m_count = count;
+
+    // Checked once here, so that replaying does not have to
+    for (quint64 i = 0; i < count; ++i)
+    {
+        double value = trace->getValue(i);
+        if (!std::isfinite(value) || value < 0.0)
+        {
+            return QSharedPointer<const TraceFile>();
+        }
+    }
+
+    QSharedPointer<const TraceFile> result = trace;
+    cache.insert(absolutePath, result);
+    return result;
+}
+
+QString TraceFile::getPath() const
+{
+    return m_file.fileName();
+}
+
+quint64 TraceFile::size() const
+{
+    return m_count;
+}
+
+double TraceFile::getValue(quint64 index) const
+{
+    return fromLittleEndian(m_data + HEADER_SIZE + index * sizeof(double));
+}
+
+const double* TraceFile::getValues() const
+{
+    if (!isLittleEndianHost())
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const double*>(m_data + HEADER_SIZE);
+}
+
+////////////////////////////////////////////////////////////////
+
+TraceFileWriter::TraceFileWriter()
+ : m_count(0)
+{}
+
+TraceFileWriter::~TraceFileWriter()
+{
+    if (m_file.isOpen())
+    {
+        close();
+    }
+}
+
+bool TraceFileWriter::open(const QString& path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    m_count = 0;
+
+    uchar header[TraceFile::HEADER_SIZE];
+    qToLittleEndian<quint32>(TraceFile::MAGIC, header);
+    qToLittleEndian<quint32>(TraceFile::VERSION, header + 4);
+    qToLittleEndian<quint64>(0, header + 8);
+    return m_file.write(reinterpret_cast<const char*>(header), sizeof(header)) == sizeof(header);
+}
+
+bool TraceFileWriter::write(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uchar data[sizeof(bits)];
+    qToLittleEndian<quint64>(bits, data);
+    if (m_file.write(reinterpret_cast<const char*>(data), sizeof(data)) != sizeof(data))
+    {
+        return false;
+    }
+
+    ++m_count;
+    return true;
+}
+
+bool TraceFileWriter::close()
+{
+    uchar count[sizeof(m_count)];
+    qToLittleEndian<quint64>(m_count, count);
+
+    bool ok = m_file.seek(8) && m_file.write(reinterpret_cast<const char*>(count), sizeof(count)) == sizeof(count);
+    m_file.close();
+    return ok;
+}
+
+quint64 TraceFileWriter::getCount() const
+{
+    return m_count;
+}
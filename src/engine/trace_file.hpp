@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QFile>
+#include <QSharedPointer>
+#include <QString>
+#include <QtGlobal>
+
+
+// Recorded times, such as inter-arrival or service times, replayed instead
+// of drawn from a distribution. The file holds a little-endian header of
+// magic, version and value count followed by the values as doubles, and is
+// memory mapped, so even long traces are not read into memory up front and
+// all stations replaying the same file share a single mapping.
+class TraceFile
+{
+public:
+    static const quint32 MAGIC;
+    static const quint32 VERSION;
+    static const int HEADER_SIZE;
+
+public:
+    ~TraceFile();
+
+    // Returns null for a missing file, a wrong header or a value that is
+    // negative or not finite
+    static QSharedPointer<const TraceFile> open(const QString& path);
+
+    QString getPath() const;
+    quint64 size() const;
+    double getValue(quint64 index) const;
+
+    // The mapped values, null on big-endian hosts where they have to be
+    // converted with getValue()
+    const double* getValues() const;
+
+private:
+    TraceFile();
+
+private:
+    QFile m_file;
+    const uchar* m_data;
+    quint64 m_count;
+};
+
+////////////////////////////////////////////////////////////////
+
+// Writes a trace file value by value, the count in the header is filled in
+// by close()
+class TraceFileWriter
+{
+public:
+    TraceFileWriter();
+    ~TraceFileWriter();
+
+    bool open(const QString& path);
+    bool write(double value);
+    bool close();
+
+    quint64 getCount() const;
+
+private:
+    QFile m_file;
+    quint64 m_count;
+};
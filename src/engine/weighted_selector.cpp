@@ -0,0 +1,77 @@
+#include "engine/weighted_selector.hpp"
+
+
+WeightedSelector::WeightedSelector()
+ : m_totalWeight(0)
+ , m_highestStep(0)
+{}
+
+void WeightedSelector::reset(const QVector<int>& weights)
+{
+    const int size = weights.size();
+
+    m_weights = weights;
+    m_tree.fill(0, size + 1);
+    m_totalWeight = 0;
+
+    for (int i = 1; i <= size; ++i)
+    {
+        m_tree[i] += weights.at(i - 1);
+        m_totalWeight += weights.at(i - 1);
+
+        int parent = i + (i & -i);
+        if (parent <= size)
+        {
+            m_tree[parent] += m_tree.at(i);
+        }
+    }
+
+    m_highestStep = 1;
+    while (m_highestStep * 2 <= size)
+    {
+        m_highestStep *= 2;
+    }
+}
+
+void WeightedSelector::setWeight(int index, int weight)
+{
+    int delta = weight - m_weights.at(index);
+    if (delta == 0)
+    {
+        return;
+    }
+
+    m_weights[index] = weight;
+    m_totalWeight += delta;
+
+    for (int i = index + 1; i < m_tree.size(); i += (i & -i))
+    {
+        m_tree[i] += delta;
+    }
+}
+
+int WeightedSelector::getWeight(int index) const
+{
+    return m_weights.at(index);
+}
+
+int WeightedSelector::getTotalWeight() const
+{
+    return m_totalWeight;
+}
+
+int WeightedSelector::find(int value) const
+{
+    int position = 0;
+    for (int step = m_highestStep; step > 0; step /= 2)
+    {
+        int next = position + step;
+        if (next < m_tree.size() && m_tree.at(next) <= value)
+        {
+            position = next;
+            value -= m_tree.at(next);
+        }
+    }
+
+    return position;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QVector>
+
+
+// Weighted random choice over a fixed number of items backed by a Fenwick
+// tree, so changing a single weight and choosing an item are O(log n).
+// Items with zero weight are never chosen.
+class WeightedSelector
+{
+public:
+    WeightedSelector();
+
+    void reset(const QVector<int>& weights);
+    void setWeight(int index, int weight);
+
+    int getWeight(int index) const;
+    int getTotalWeight() const;
+
+    // Returns the item covering the given value in [0, getTotalWeight())
+    // when weights are laid out one after another
+    int find(int value) const;
+
+private:
+    QVector<int> m_weights;
+    QVector<int> m_tree;
+    int m_totalWeight;
+    int m_highestStep;
+};
@@ -0,0 +1,83 @@
+#include "stats/sequential_stopping_rule.hpp"
+
+#include "stats/stat_factory.hpp"
+
+#include <cmath>
+#include <limits>
+
+
+const int SequentialStoppingRule::MIN_OBSERVATIONS;
+constexpr double SequentialStoppingRule::DEFAULT_CONFIDENCE_LEVEL;
+constexpr double SequentialStoppingRule::DEFAULT_OBSERVATION_INTERVAL;
+
+SequentialStoppingRule::SequentialStoppingRule(StatType type,
+                                               int stationId,
+                                               double relativePrecision,
+                                               double confidenceLevel,
+                                               double observationInterval)
+ : m_stat(StatFactory::createStat(type, stationId), observationInterval)
+ , m_relativePrecision(relativePrecision)
+ , m_confidenceLevel(confidenceLevel)
+{
+    reset();
+}
+
+void SequentialStoppingRule::reset()
+{
+    m_stat.reset();
+    m_halfWidth = std::numeric_limits<double>::infinity();
+    m_lastObservationCount = 0;
+    m_satisfied = false;
+}
+
+bool SequentialStoppingRule::isSatisfied() const
+{
+    return m_satisfied;
+}
+
+double SequentialStoppingRule::getMean() const
+{
+    return m_stat.getValue();
+}
+
+double SequentialStoppingRule::getHalfWidth() const
+{
+    return m_halfWidth;
+}
+
+double SequentialStoppingRule::getRelativePrecision() const
+{
+    return m_relativePrecision;
+}
+
+double SequentialStoppingRule::getConfidenceLevel() const
+{
+    return m_confidenceLevel;
+}
+
+const SteadyStateStat& SequentialStoppingRule::getStat() const
+{
+    return m_stat;
+}
+
+void SequentialStoppingRule::eventProcessed(const Event& event)
+{
+    m_stat.update(event);
+
+    if (m_stat.getObservationCount() != m_lastObservationCount)
+    {
+        m_lastObservationCount = m_stat.getObservationCount();
+        check();
+    }
+}
+
+void SequentialStoppingRule::check()
+{
+    if (m_lastObservationCount < MIN_OBSERVATIONS)
+    {
+        return;
+    }
+
+    m_halfWidth = m_stat.getConfidenceHalfWidth(m_confidenceLevel);
+    m_satisfied = m_halfWidth <= m_relativePrecision * std::fabs(m_stat.getValue());
+}
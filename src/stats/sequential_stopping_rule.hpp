@@ -0,0 +1,49 @@
+#pragma once
+
+#include "engine/event_listener.hpp"
+#include "stats/stat_type.hpp"
+#include "stats/steady_state_stat.hpp"
+
+
+// Tells when the steady-state mean of a stat is known to a given relative
+// precision, e.g. +-1% at 95% confidence. The stat is observed through a
+// SteadyStateStat and the precision is checked each time an observation
+// is added, but only once at least MIN_OBSERVATIONS have been collected.
+// Use it as the predicate of a StopCondition to run only as long as needed.
+class SequentialStoppingRule : public EventListener
+{
+public:
+    static const int MIN_OBSERVATIONS = 200;
+    static constexpr double DEFAULT_CONFIDENCE_LEVEL = 0.95;
+    static constexpr double DEFAULT_OBSERVATION_INTERVAL = 1.0;
+
+public:
+    SequentialStoppingRule(StatType type,
+                           int stationId,
+                           double relativePrecision,
+                           double confidenceLevel = DEFAULT_CONFIDENCE_LEVEL,
+                           double observationInterval = DEFAULT_OBSERVATION_INTERVAL);
+
+    void reset();
+
+    bool isSatisfied() const;
+    double getMean() const;
+    double getHalfWidth() const;
+    double getRelativePrecision() const;
+    double getConfidenceLevel() const;
+
+    const SteadyStateStat& getStat() const;
+
+    virtual void eventProcessed(const Event& event) override;
+
+private:
+    void check();
+
+private:
+    SteadyStateStat m_stat;
+    double m_relativePrecision;
+    double m_confidenceLevel;
+    double m_halfWidth;
+    int m_lastObservationCount;
+    bool m_satisfied;
+};
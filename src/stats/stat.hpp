@@ -2,11 +2,17 @@
 
 #include "engine/event.hpp"
 
+// Base of all statistics. The value is a weighted mean, the sum of the
+// observed quantity divided by its total weight (elapsed time for time
+// averages, number of tasks for per-task averages). Sum and weight are
+// exposed so that means over intervals can be derived from them.
 class Stat
 {
 public:
     Stat() :
      m_value(0.0)
+     , m_sum(0.0)
+     , m_weight(0.0)
     {}
     virtual ~Stat() {}
 
@@ -18,6 +24,31 @@ public:
         return m_value;
     }
 
+    double getSum() const
+    {
+        return m_sum;
+    }
+
+    double getWeight() const
+    {
+        return m_weight;
+    }
+
+protected:
+    void resetValue()
+    {
+        m_value = 0.0;
+        m_sum = 0.0;
+        m_weight = 0.0;
+    }
+
+    void updateValue()
+    {
+        m_value = m_weight > 0.0 ? m_sum / m_weight : 0.0;
+    }
+
 protected:
     double m_value;
+    double m_sum;
+    double m_weight;
 };
@@ -0,0 +1,83 @@
+#include "stats/stat_factory.hpp"
+
+#include "stats/station_stats.hpp"
+#include "stats/system_stats.hpp"
+
+
+QList<StatType> StatFactory::getTypes()
+{
+    return QList<StatType>()
+        << StatType::SystemMeanTaskProcessingTime
+        << StatType::SystemMeanNumberOfTasks
+        << StatType::StationMeanUtilizedProcessors
+        << StatType::StationMeanWaitTime
+        << StatType::StationMeanQueueLength;
+}
+
+Stat* StatFactory::createStat(StatType type, int stationId)
+{
+    Stat* stat = nullptr;
+    switch (type)
+    {
+        case StatType::SystemMeanTaskProcessingTime:
+            stat = new SystemMeanTaskProcessingTimeStat();
+            break;
+
+        case StatType::SystemMeanNumberOfTasks:
+            stat = new SystemMeanNumberOfTasksStat();
+            break;
+
+        case StatType::StationMeanUtilizedProcessors:
+            stat = new StationMeanUtilizedProcessorsStat(stationId);
+            break;
+
+        case StatType::StationMeanQueueLength:
+            stat = new StationMeanQueueLengthStat(stationId);
+            break;
+
+        case StatType::StationMeanWaitTime:
+            stat = new StationMeanWaitTimeStat(stationId);
+            break;
+    }
+
+    return stat;
+}
+
+bool StatFactory::isStationStat(StatType type)
+{
+    return type != StatType::SystemMeanTaskProcessingTime &&
+           type != StatType::SystemMeanNumberOfTasks;
+}
+
+QString StatFactory::getName(StatType type)
+{
+    switch (type)
+    {
+        case StatType::SystemMeanTaskProcessingTime:
+            return QString::fromUtf8("T_t syst.");
+
+        case StatType::SystemMeanNumberOfTasks:
+            return QString::fromUtf8("N_t syst.");
+
+        case StatType::StationMeanUtilizedProcessors:
+            return QString::fromUtf8("U_p stat.");
+
+        case StatType::StationMeanQueueLength:
+            return QString::fromUtf8("N_q stat.");
+
+        case StatType::StationMeanWaitTime:
+            return QString::fromUtf8("T_q stat.");
+    }
+
+    return QString();
+}
+
+QString StatFactory::getName(StatType type, int stationId)
+{
+    if (!isStationStat(type))
+    {
+        return getName(type);
+    }
+
+    return QString("%1 %2").arg(getName(type)).arg(stationId);
+}
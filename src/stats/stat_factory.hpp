@@ -0,0 +1,19 @@
+#pragma once
+
+#include "stats/stat.hpp"
+#include "stats/stat_type.hpp"
+
+#include <QList>
+#include <QString>
+
+
+class StatFactory
+{
+public:
+    static QList<StatType> getTypes();
+
+    static Stat* createStat(StatType type, int stationId);
+    static bool isStationStat(StatType type);
+    static QString getName(StatType type);
+    static QString getName(StatType type, int stationId);
+};
@@ -29,19 +29,16 @@ StationMeanUtilizedProcessorsStat::StationMeanUtilizedProcessorsStat(int station
 
 void StationMeanUtilizedProcessorsStat::reset()
 {
-    m_processorUtilizationTimes.clear();
+    resetValue();
+    m_lastEventTime = 0.0;
     m_numberOfUtilizedProcessors = 0;
 }
 
 void StationMeanUtilizedProcessorsStat::updateSelf(Event event)
 {
-    while (m_processorUtilizationTimes.size() < m_numberOfUtilizedProcessors+1)
-    {
-        m_processorUtilizationTimes.append(0.0);
-    }
-
     double deltaTime = event.time - m_lastEventTime;
-    m_processorUtilizationTimes[m_numberOfUtilizedProcessors] += deltaTime;
+    m_sum += m_numberOfUtilizedProcessors * deltaTime;
+    m_weight += deltaTime;
 
     if (event.type == EventType::TaskStartedProcessing)
     {
@@ -52,23 +49,7 @@ void StationMeanUtilizedProcessorsStat::updateSelf(Event event)
         --m_numberOfUtilizedProcessors;
     }
 
-    m_value = 0.0;
-    double total = 0.0;
-
-    for (int i = 0; i < m_processorUtilizationTimes.size(); ++i)
-    {
-        m_value += i * m_processorUtilizationTimes[i];
-        total += m_processorUtilizationTimes[i];
-    }
-
-    if (total > 0.0)
-    {
-        m_value /= total;
-    }
-    else
-    {
-        m_value = 0.0;
-    }
+    updateValue();
 }
 
 //////////////////////////////////////
@@ -80,19 +61,16 @@ StationMeanQueueLengthStat::StationMeanQueueLengthStat(int stationId)
 
 void StationMeanQueueLengthStat::reset()
 {
-    m_queueLengthTimes.clear();
+    resetValue();
+    m_lastEventTime = 0.0;
     m_numberOfTasksInQueue = 0;
 }
 
 void StationMeanQueueLengthStat::updateSelf(Event event)
 {
-    while (m_queueLengthTimes.size() < m_numberOfTasksInQueue+1)
-    {
-        m_queueLengthTimes.append(0.0);
-    }
-
     double deltaTime = event.time - m_lastEventTime;
-    m_queueLengthTimes[m_numberOfTasksInQueue] += deltaTime;
+    m_sum += m_numberOfTasksInQueue * deltaTime;
+    m_weight += deltaTime;
 
     if (event.type == EventType::TaskAddedToQueue)
     {
@@ -103,38 +81,20 @@ void StationMeanQueueLengthStat::updateSelf(Event event)
         --m_numberOfTasksInQueue;
     }
 
-    m_value = 0.0;
-    double total = 0.0;
-
-    for (int i = 0; i < m_queueLengthTimes.size(); ++i)
-    {
-        m_value += i * m_queueLengthTimes[i];
-        total += m_queueLengthTimes[i];
-    }
-
-    if (total > 0.0)
-    {
-        m_value /= total;
-    }
-    else
-    {
-        m_value = 0.0;
-    }
+    updateValue();
 }
 
 //////////////////////////////////////
 
 StationMeanWaitTimeStat::StationMeanWaitTimeStat(int stationId)
  : StationStat(stationId)
- , m_numberOfProcessedTasks(0)
- , m_totalWaitTime(0.0)
 {}
 
 void StationMeanWaitTimeStat::reset()
 {
+    resetValue();
+    m_lastEventTime = 0.0;
     m_taskEntryTimes.clear();
-    m_numberOfProcessedTasks = 0;
-    m_totalWaitTime = 0.0;
 }
 
 void StationMeanWaitTimeStat::updateSelf(Event event)
@@ -145,18 +105,11 @@ void StationMeanWaitTimeStat::updateSelf(Event event)
     }
     else if (event.type == EventType::TaskStartedProcessing)
     {
-        ++m_numberOfProcessedTasks;
         double entryTime = m_taskEntryTimes.value(event.taskId);
-        m_totalWaitTime += (event.time - entryTime);
+        m_sum += (event.time - entryTime);
+        m_weight += 1.0;
         m_taskEntryTimes.remove(event.taskId);
     }
 
-    if (m_numberOfProcessedTasks > 0)
-    {
-        m_value = m_totalWaitTime / m_numberOfProcessedTasks;
-    }
-    else
-    {
-        m_value = 0.0;
-    }
+    updateValue();
 }
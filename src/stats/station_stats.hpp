@@ -3,7 +3,6 @@
 #include "stats/stat.hpp"
 
 #include <QHash>
-#include <QList>
 
 
 class StationStat : public Stat
@@ -34,7 +33,6 @@ protected:
     virtual void updateSelf(Event event) override;
 
 protected:
-    QList<double> m_processorUtilizationTimes;
     int m_numberOfUtilizedProcessors;
 };
 
@@ -51,7 +49,6 @@ protected:
     virtual void updateSelf(Event event) override;
 
 private:
-    QList<double> m_queueLengthTimes;
     int m_numberOfTasksInQueue;
 };
 
@@ -69,6 +66,4 @@ protected:
 
 private:
     QHash<int, double> m_taskEntryTimes;
-    int m_numberOfProcessedTasks;
-    double m_totalWaitTime;
 };
@@ -0,0 +1,62 @@
+#include "stats/stats_collector.hpp"
+
+#include "stats/stat_factory.hpp"
+
+
+StatsCollector::StatsCollector()
+{}
+
+StatsCollector::~StatsCollector()
+{
+    clear();
+}
+
+void StatsCollector::addStat(StatType type, int stationId)
+{
+    Stat* stat = StatFactory::createStat(type, stationId);
+    stat->reset();
+
+    m_stats.append(stat);
+    m_names.append(StatFactory::getName(type, stationId));
+}
+
+void StatsCollector::addStat(const QString& name, Stat* stat)
+{
+    m_stats.append(stat);
+    m_names.append(name);
+}
+
+void StatsCollector::clear()
+{
+    qDeleteAll(m_stats);
+    m_stats.clear();
+    m_names.clear();
+}
+
+int StatsCollector::getStatCount() const
+{
+    return m_stats.size();
+}
+
+QString StatsCollector::getName(int index) const
+{
+    return m_names.at(index);
+}
+
+double StatsCollector::getValue(int index) const
+{
+    return m_stats.at(index)->getValue();
+}
+
+const Stat* StatsCollector::getStat(int index) const
+{
+    return m_stats.at(index);
+}
+
+void StatsCollector::eventProcessed(const Event& event)
+{
+    for (Stat* stat : m_stats)
+    {
+        stat->update(event);
+    }
+}
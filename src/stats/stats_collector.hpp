@@ -0,0 +1,38 @@
+#pragma once
+
+#include "engine/event_listener.hpp"
+#include "stats/stat.hpp"
+#include "stats/stat_type.hpp"
+
+#include <QList>
+#include <QString>
+
+
+// Owns a set of stats and updates all of them with every event processed by
+// the simulation it listens to
+class StatsCollector : public EventListener
+{
+public:
+    StatsCollector();
+    virtual ~StatsCollector();
+
+    void addStat(StatType type, int stationId);
+    // Takes ownership of the stat
+    void addStat(const QString& name, Stat* stat);
+    void clear();
+
+    int getStatCount() const;
+    QString getName(int index) const;
+    double getValue(int index) const;
+    const Stat* getStat(int index) const;
+
+    virtual void eventProcessed(const Event& event) override;
+
+private:
+    StatsCollector(const StatsCollector&) = delete;
+    StatsCollector& operator=(const StatsCollector&) = delete;
+
+private:
+    QList<Stat*> m_stats;
+    QList<QString> m_names;
+};
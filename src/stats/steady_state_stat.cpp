@@ -0,0 +1,267 @@
+#include "stats/steady_state_stat.hpp"
+
+#include "stats/welford_accumulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const int MSER_BATCH_SIZE = 5;
+}
+
+
+const int SteadyStateStat::MAX_OBSERVATIONS;
+const int SteadyStateStat::DEFAULT_BATCH_COUNT;
+
+SteadyStateStat::SteadyStateStat(Stat* stat, double observationInterval)
+ : m_stat(stat)
+ , m_initialInterval(observationInterval)
+ , m_requestedBatchCount(DEFAULT_BATCH_COUNT)
+{
+    reset();
+}
+
+SteadyStateStat::~SteadyStateStat()
+{
+    delete m_stat;
+    m_stat = nullptr;
+}
+
+bool SteadyStateStat::update(Event event)
+{
+    bool updated = m_stat->update(event);
+
+    if (event.time >= m_nextObservationTime)
+    {
+        addObservation(event.time);
+        updated = true;
+    }
+
+    return updated;
+}
+
+void SteadyStateStat::reset()
+{
+    resetValue();
+    m_stat->reset();
+
+    m_interval = m_initialInterval;
+    m_nextObservationTime = m_interval;
+    m_lastSum = 0.0;
+    m_lastWeight = 0.0;
+
+    m_observations.clear();
+    m_warmUpObservationCount = 0;
+    m_batchMeans.clear();
+}
+
+const Stat* SteadyStateStat::getStat() const
+{
+    return m_stat;
+}
+
+void SteadyStateStat::setBatchCount(int batchCount)
+{
+    m_requestedBatchCount = std::max(batchCount, 2);
+    computeBatchMeans();
+}
+
+int SteadyStateStat::getObservationCount() const
+{
+    return m_observations.size();
+}
+
+int SteadyStateStat::getWarmUpObservationCount() const
+{
+    return m_warmUpObservationCount;
+}
+
+double SteadyStateStat::getWarmUpTime() const
+{
+    if (m_warmUpObservationCount == 0)
+    {
+        return 0.0;
+    }
+
+    return m_observations.at(m_warmUpObservationCount - 1).endTime;
+}
+
+int SteadyStateStat::getBatchCount() const
+{
+    return m_batchMeans.size();
+}
+
+double SteadyStateStat::getStandardError() const
+{
+    WelfordAccumulator accumulator;
+    for (double batchMean : m_batchMeans)
+    {
+        accumulator.add(batchMean);
+    }
+
+    return accumulator.getStandardError();
+}
+
+double SteadyStateStat::getConfidenceHalfWidth(double confidenceLevel) const
+{
+    WelfordAccumulator accumulator;
+    for (double batchMean : m_batchMeans)
+    {
+        accumulator.add(batchMean);
+    }
+
+    return accumulator.getConfidenceHalfWidth(confidenceLevel);
+}
+
+// An interval in which the wrapped stat got no weight (e.g. no task was
+// completed) is joined with the next one
+void SteadyStateStat::addObservation(double time)
+{
+    m_nextObservationTime += m_interval * (std::floor((time - m_nextObservationTime) / m_interval) + 1.0);
+
+    Observation observation;
+    observation.sum = m_stat->getSum() - m_lastSum;
+    observation.weight = m_stat->getWeight() - m_lastWeight;
+    observation.endTime = time;
+
+    if (observation.weight <= 0.0)
+    {
+        return;
+    }
+
+    m_lastSum = m_stat->getSum();
+    m_lastWeight = m_stat->getWeight();
+    m_observations.append(observation);
+
+    if (m_observations.size() >= MAX_OBSERVATIONS)
+    {
+        mergeObservations();
+    }
+
+    truncateWarmUp();
+    computeBatchMeans();
+}
+
+void SteadyStateStat::mergeObservations()
+{
+    int mergedCount = m_observations.size() / 2;
+    for (int i = 0; i < mergedCount; ++i)
+    {
+        const Observation& first = m_observations.at(2 * i);
+        const Observation& second = m_observations.at(2 * i + 1);
+
+        Observation merged;
+        merged.sum = first.sum + second.sum;
+        merged.weight = first.weight + second.weight;
+        merged.endTime = second.endTime;
+        m_observations[i] = merged;
+    }
+
+    if (m_observations.size() % 2 != 0)
+    {
+        m_observations[mergedCount] = m_observations.last();
+        ++mergedCount;
+    }
+
+    m_observations.resize(mergedCount);
+    m_interval *= 2.0;
+}
+
+// MSER-5: the series is grouped into batches of five observations and the
+// number d of leading batches to drop is the one minimizing the variance of
+// the remaining batch means divided by (k - d)^2. Only the first half of the
+// series is considered for truncation.
+void SteadyStateStat::truncateWarmUp()
+{
+    int batchCount = m_observations.size() / MSER_BATCH_SIZE;
+    if (batchCount < 2)
+    {
+        m_warmUpObservationCount = 0;
+        return;
+    }
+
+    QVector<double> batchMeans(batchCount);
+    for (int i = 0; i < batchCount; ++i)
+    {
+        double sum = 0.0;
+        double weight = 0.0;
+        for (int j = i * MSER_BATCH_SIZE; j < (i + 1) * MSER_BATCH_SIZE; ++j)
+        {
+            sum += m_observations.at(j).sum;
+            weight += m_observations.at(j).weight;
+        }
+        batchMeans[i] = sum / weight;
+    }
+
+    // Suffix sums of the batch means and their squares
+    double sum = 0.0;
+    double sumOfSquares = 0.0;
+    double bestStatistic = std::numeric_limits<double>::infinity();
+    int bestTruncation = 0;
+
+    for (int d = batchCount - 1; d >= 0; --d)
+    {
+        sum += batchMeans.at(d);
+        sumOfSquares += batchMeans.at(d) * batchMeans.at(d);
+
+        if (d > batchCount / 2)
+        {
+            continue;
+        }
+
+        double count = batchCount - d;
+        double variance = std::max(0.0, sumOfSquares - sum * sum / count);
+        double statistic = variance / (count * count);
+
+        if (statistic <= bestStatistic)
+        {
+            bestStatistic = statistic;
+            bestTruncation = d;
+        }
+    }
+
+    m_warmUpObservationCount = bestTruncation * MSER_BATCH_SIZE;
+}
+
+// Leftover observations which do not fill a whole batch are taken from the
+// start of the series, closest to the warm-up
+void SteadyStateStat::computeBatchMeans()
+{
+    m_batchMeans.clear();
+
+    double totalSum = 0.0;
+    double totalWeight = 0.0;
+    for (int i = m_warmUpObservationCount; i < m_observations.size(); ++i)
+    {
+        totalSum += m_observations.at(i).sum;
+        totalWeight += m_observations.at(i).weight;
+    }
+
+    m_sum = totalSum;
+    m_weight = totalWeight;
+    updateValue();
+
+    int remainingCount = m_observations.size() - m_warmUpObservationCount;
+    int batchCount = std::min(m_requestedBatchCount, remainingCount);
+    if (batchCount == 0)
+    {
+        return;
+    }
+
+    int batchSize = remainingCount / batchCount;
+    int first = m_observations.size() - batchCount * batchSize;
+
+    for (int i = 0; i < batchCount; ++i)
+    {
+        double sum = 0.0;
+        double weight = 0.0;
+        for (int j = first + i * batchSize; j < first + (i + 1) * batchSize; ++j)
+        {
+            sum += m_observations.at(j).sum;
+            weight += m_observations.at(j).weight;
+        }
+        m_batchMeans.append(sum / weight);
+    }
+}
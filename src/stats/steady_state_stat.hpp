@@ -0,0 +1,72 @@
+#pragma once
+
+#include "stats/stat.hpp"
+
+#include <QVector>
+
+
+// Steady-state estimate of another stat. The wrapped stat's sum and weight
+// are sampled every observation interval, giving a series of interval means.
+// The warm-up part of the series is cut off with the MSER-5 rule and the
+// rest is split into non-overlapping batches whose means give a confidence
+// interval. The value of this stat is the mean after the warm-up.
+//
+// At most MAX_OBSERVATIONS are kept; when that many have been collected,
+// neighbouring observations are merged in pairs and the interval doubles.
+class SteadyStateStat : public Stat
+{
+public:
+    static const int MAX_OBSERVATIONS = 1024;
+    static const int DEFAULT_BATCH_COUNT = 20;
+
+public:
+    // Takes ownership of the stat
+    SteadyStateStat(Stat* stat, double observationInterval);
+    virtual ~SteadyStateStat();
+
+    virtual bool update(Event event) override;
+    virtual void reset() override;
+
+    const Stat* getStat() const;
+
+    void setBatchCount(int batchCount);
+
+    int getObservationCount() const;
+    int getWarmUpObservationCount() const;
+    double getWarmUpTime() const;
+    int getBatchCount() const;
+
+    double getStandardError() const;
+    // Infinite until there are at least two batches
+    double getConfidenceHalfWidth(double confidenceLevel) const;
+
+private:
+    struct Observation
+    {
+        double sum;
+        double weight;
+        double endTime;
+    };
+
+private:
+    SteadyStateStat(const SteadyStateStat&) = delete;
+    SteadyStateStat& operator=(const SteadyStateStat&) = delete;
+
+    void addObservation(double time);
+    void mergeObservations();
+    void truncateWarmUp();
+    void computeBatchMeans();
+
+private:
+    Stat* m_stat;
+    double m_initialInterval;
+    double m_interval;
+    double m_nextObservationTime;
+    double m_lastSum;
+    double m_lastWeight;
+    int m_requestedBatchCount;
+
+    QVector<Observation> m_observations;
+    int m_warmUpObservationCount;
+    QVector<double> m_batchMeans;
+};
@@ -20,14 +20,13 @@ bool SystemStat::update(Event event)
 //////////////////////////////////////
 
 SystemMeanTaskProcessingTimeStat::SystemMeanTaskProcessingTimeStat()
- : m_totalProcessingTime(0.0)
 {}
 
 void SystemMeanTaskProcessingTimeStat::reset()
 {
+    resetValue();
+    m_lastEventTime = 0.0;
     m_taskEntryTimes.clear();
-    m_totalProcessingTime = 0.0;
-    m_totalNumberOfTasks = 0.0;
 }
 
 void SystemMeanTaskProcessingTimeStat::updateSelf(Event event)
@@ -40,18 +39,11 @@ void SystemMeanTaskProcessingTimeStat::updateSelf(Event event)
     {
         double entryTime = m_taskEntryTimes.value(event.taskId);
         m_taskEntryTimes.remove(event.taskId);
-        m_totalProcessingTime += (event.time - entryTime);
-        ++m_totalNumberOfTasks;
+        m_sum += (event.time - entryTime);
+        m_weight += 1.0;
     }
 
-    if (m_totalNumberOfTasks > 0)
-    {
-        m_value = m_totalProcessingTime / m_totalNumberOfTasks;
-    }
-    else
-    {
-        m_totalNumberOfTasks = 0;
-    }
+    updateValue();
 }
 
 //////////////////////////////////////
@@ -62,19 +54,16 @@ SystemMeanNumberOfTasksStat::SystemMeanNumberOfTasksStat()
 
 void SystemMeanNumberOfTasksStat::reset()
 {
-    m_taskCountTimes.clear();
+    resetValue();
+    m_lastEventTime = 0.0;
     m_numberOfTasks = 0;
 }
 
 void SystemMeanNumberOfTasksStat::updateSelf(Event event)
 {
-    while (m_taskCountTimes.size() < m_numberOfTasks+1)
-    {
-        m_taskCountTimes.append(0.0);
-    }
-
     double deltaTime = event.time - m_lastEventTime;
-    m_taskCountTimes[m_numberOfTasks] += deltaTime;
+    m_sum += m_numberOfTasks * deltaTime;
+    m_weight += deltaTime;
 
     if (event.type == EventType::TaskInput)
     {
@@ -85,21 +74,5 @@ void SystemMeanNumberOfTasksStat::updateSelf(Event event)
         --m_numberOfTasks;
     }
 
-    m_value = 0.0;
-    double total = 0.0;
-
-    for (int i = 0; i < m_taskCountTimes.size(); ++i)
-    {
-        m_value += i * m_taskCountTimes[i];
-        total += m_taskCountTimes[i];
-    }
-
-    if (total > 0.0)
-    {
-        m_value /= total;
-    }
-    else
-    {
-        m_value = 0;
-    }
+    updateValue();
 }
@@ -33,8 +33,6 @@ protected:
 
 private:
     QHash<int, double> m_taskEntryTimes;
-    double m_totalProcessingTime;
-    int m_totalNumberOfTasks;
 };
 
 //////////////////////////////////////
@@ -50,6 +48,5 @@ protected:
     virtual void updateSelf(Event event) override;
 
 private:
-    QList<double> m_taskCountTimes;
     int m_numberOfTasks;
 };
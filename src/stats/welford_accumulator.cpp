@@ -0,0 +1,95 @@
+#include "stats/welford_accumulator.hpp"
+
+#include <boost/math/distributions/students_t.hpp>
+
+#include <cmath>
+#include <limits>
+
+
+WelfordAccumulator::WelfordAccumulator()
+{
+    clear();
+}
+
+void WelfordAccumulator::add(double value)
+{
+    ++m_count;
+    double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_sumOfSquares += delta * (value - m_mean);
+}
+
+void WelfordAccumulator::merge(const WelfordAccumulator& other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+
+    if (m_count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    double count = static_cast<double>(m_count) + other.m_count;
+    double delta = other.m_mean - m_mean;
+
+    m_mean += delta * other.m_count / count;
+    m_sumOfSquares += other.m_sumOfSquares + delta * delta * m_count * other.m_count / count;
+    m_count += other.m_count;
+}
+
+void WelfordAccumulator::clear()
+{
+    m_count = 0;
+    m_mean = 0.0;
+    m_sumOfSquares = 0.0;
+}
+
+quint64 WelfordAccumulator::getCount() const
+{
+    return m_count;
+}
+
+double WelfordAccumulator::getMean() const
+{
+    return m_mean;
+}
+
+double WelfordAccumulator::getVariance() const
+{
+    if (m_count < 2)
+    {
+        return 0.0;
+    }
+
+    return m_sumOfSquares / (m_count - 1);
+}
+
+double WelfordAccumulator::getStandardDeviation() const
+{
+    return std::sqrt(getVariance());
+}
+
+double WelfordAccumulator::getStandardError() const
+{
+    if (m_count == 0)
+    {
+        return 0.0;
+    }
+
+    return std::sqrt(getVariance() / m_count);
+}
+
+double WelfordAccumulator::getConfidenceHalfWidth(double confidenceLevel) const
+{
+    if (m_count < 2)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    boost::math::students_t distribution(static_cast<double>(m_count - 1));
+    double quantile = boost::math::quantile(distribution, 0.5 + confidenceLevel / 2.0);
+    return quantile * getStandardError();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QtGlobal>
+
+
+// Running mean and variance of a series of observations (Welford's method).
+// Accumulators filled independently, e.g. in different threads, can be
+// merged into one (Chan et al.), which gives the same result as if all the
+// observations were added to a single accumulator.
+class WelfordAccumulator
+{
+public:
+    WelfordAccumulator();
+
+    void add(double value);
+    void merge(const WelfordAccumulator& other);
+    void clear();
+
+    quint64 getCount() const;
+    double getMean() const;
+    double getVariance() const;
+    double getStandardDeviation() const;
+    double getStandardError() const;
+
+    // Half width of the Student's t confidence interval for the mean, e.g.
+    // for confidenceLevel = 0.95; infinite for fewer than two observations
+    double getConfidenceHalfWidth(double confidenceLevel) const;
+
+private:
+    quint64 m_count;
+    double m_mean;
+    double m_sumOfSquares;
+};
@@ -2,12 +2,80 @@
 
 #include "ui_distribution_params_widget.h"
 
+#include "engine/distribution_sampler.hpp"
+#include "engine/empirical_table.hpp"
+#include "engine/trace_file.hpp"
+
+#include <QFileDialog>
+#include <QStringList>
+
 namespace
 {
     const int CONSTANT_PAGE_INDEX = 0;
     const int UNIFORM_PAGE_INDEX = 1;
     const int NORMAL_PAGE_INDEX = 2;
     const int EXPONENTIAL_PAGE_INDEX = 3;
+    const int LOGNORMAL_PAGE_INDEX = 4;
+    const int GAMMA_PAGE_INDEX = 5;
+    const int ERLANG_PAGE_INDEX = 6;
+    const int WEIBULL_PAGE_INDEX = 7;
+    const int HYPER_EXPONENTIAL_PAGE_INDEX = 8;
+    const int PHASE_TYPE_PAGE_INDEX = 9;
+    const int MARKOV_MODULATED_POISSON_PAGE_INDEX = 10;
+    const int MARKOVIAN_ARRIVAL_PAGE_INDEX = 11;
+    const int NON_HOMOGENEOUS_POISSON_PAGE_INDEX = 12;
+    const int EMPIRICAL_PAGE_INDEX = 13;
+    const int TRACE_PAGE_INDEX = 14;
+
+    const char* INVALID_PARAMS_STYLE = "color: red";
+
+    // Parameter lists are edited the way they are written to model files,
+    // numbers separated by underscores
+    QVector<double> parseParamList(const QString& text)
+    {
+        QVector<double> params;
+        for (const QString& component : text.split("_"))
+        {
+            bool ok = false;
+            params.append(component.toDouble(&ok));
+            if (!ok)
+            {
+                return QVector<double>();
+            }
+        }
+
+        return params;
+    }
+
+    // Full precision, rounded matrix rows would no longer sum to zero
+    QString paramListToString(const QVector<double>& params)
+    {
+        QStringList components;
+        for (double param : params)
+        {
+            components.append(QString::number(param, 'g', 17));
+        }
+
+        return components.join("_");
+    }
+
+    // Distributions over phases are edited with the number of phases first
+    void setPhaseParams(Distribution& distribution, const QString& text)
+    {
+        QVector<double> params = parseParamList(text);
+        if (!params.isEmpty())
+        {
+            distribution.param1 = params.takeFirst();
+            distribution.params = params;
+        }
+    }
+
+    QString phaseParamsToString(const Distribution& distribution)
+    {
+        QVector<double> params = distribution.params;
+        params.prepend(distribution.param1);
+        return paramListToString(params);
+    }
 };
 
 
@@ -19,6 +87,10 @@ DistributionParamsWidget::DistributionParamsWidget(QWidget* parent)
 
     connect(m_ui->distributionComboBox, SIGNAL(currentIndexChanged(int)),
             this, SLOT(setStackedWidgetIndex(int)));
+    connect(m_ui->empiricalTableBrowseButton, SIGNAL(clicked()),
+            this, SLOT(browseEmpiricalTable()));
+    connect(m_ui->traceFileBrowseButton, SIGNAL(clicked()),
+            this, SLOT(browseTraceFile()));
 
     connectControls();
 
@@ -34,7 +106,7 @@ DistributionParamsWidget::~DistributionParamsWidget()
 void DistributionParamsWidget::connectControls()
 {
     connect(m_ui->distributionComboBox, SIGNAL(currentIndexChanged(int)),
-            this, SIGNAL(distributionParamsChanged()));
+            this, SLOT(paramsChanged()));
 
     connect(m_ui->constantValueSpinBox, SIGNAL(valueChanged(double)),
             this, SIGNAL(distributionParamsChanged()));
@@ -51,12 +123,51 @@ void DistributionParamsWidget::connectControls()
 
     connect(m_ui->exponentialMeanSpinBox, SIGNAL(valueChanged(double)),
             this, SIGNAL(distributionParamsChanged()));
+
+    connect(m_ui->lognormalMeanSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+    connect(m_ui->lognormalStdDevSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+
+    connect(m_ui->gammaShapeSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+    connect(m_ui->gammaScaleSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+
+    connect(m_ui->erlangPhaseCountSpinBox, SIGNAL(valueChanged(int)),
+            this, SIGNAL(distributionParamsChanged()));
+    connect(m_ui->erlangPhaseMeanSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+
+    connect(m_ui->weibullShapeSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+    connect(m_ui->weibullScaleSpinBox, SIGNAL(valueChanged(double)),
+            this, SIGNAL(distributionParamsChanged()));
+
+    connect(m_ui->hyperExponentialBranchesLineEdit, SIGNAL(textChanged(QString)),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->phaseTypeParamsLineEdit, SIGNAL(textChanged(QString)),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->markovModulatedPoissonParamsLineEdit, SIGNAL(textChanged(QString)),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->markovianArrivalParamsLineEdit, SIGNAL(textChanged(QString)),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->nonHomogeneousPoissonScheduleLineEdit, SIGNAL(textChanged(QString)),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->nonHomogeneousPoissonLinearCheckBox, SIGNAL(toggled(bool)),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->empiricalTableLineEdit, SIGNAL(editingFinished()),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->traceFileLineEdit, SIGNAL(editingFinished()),
+            this, SLOT(paramsChanged()));
+    connect(m_ui->traceLoopCheckBox, SIGNAL(toggled(bool)),
+            this, SLOT(paramsChanged()));
 }
 
 void DistributionParamsWidget::disconnectControls()
 {
     disconnect(m_ui->distributionComboBox, SIGNAL(currentIndexChanged(int)),
-               this, SIGNAL(distributionParamsChanged()));
+               this, SLOT(paramsChanged()));
 
     disconnect(m_ui->constantValueSpinBox, SIGNAL(valueChanged(double)),
                this, SIGNAL(distributionParamsChanged()));
@@ -73,6 +184,45 @@ void DistributionParamsWidget::disconnectControls()
 
     disconnect(m_ui->exponentialMeanSpinBox, SIGNAL(valueChanged(double)),
                this, SIGNAL(distributionParamsChanged()));
+
+    disconnect(m_ui->lognormalMeanSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+    disconnect(m_ui->lognormalStdDevSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+
+    disconnect(m_ui->gammaShapeSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+    disconnect(m_ui->gammaScaleSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+
+    disconnect(m_ui->erlangPhaseCountSpinBox, SIGNAL(valueChanged(int)),
+               this, SIGNAL(distributionParamsChanged()));
+    disconnect(m_ui->erlangPhaseMeanSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+
+    disconnect(m_ui->weibullShapeSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+    disconnect(m_ui->weibullScaleSpinBox, SIGNAL(valueChanged(double)),
+               this, SIGNAL(distributionParamsChanged()));
+
+    disconnect(m_ui->hyperExponentialBranchesLineEdit, SIGNAL(textChanged(QString)),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->phaseTypeParamsLineEdit, SIGNAL(textChanged(QString)),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->markovModulatedPoissonParamsLineEdit, SIGNAL(textChanged(QString)),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->markovianArrivalParamsLineEdit, SIGNAL(textChanged(QString)),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->nonHomogeneousPoissonScheduleLineEdit, SIGNAL(textChanged(QString)),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->nonHomogeneousPoissonLinearCheckBox, SIGNAL(toggled(bool)),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->empiricalTableLineEdit, SIGNAL(editingFinished()),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->traceFileLineEdit, SIGNAL(editingFinished()),
+               this, SLOT(paramsChanged()));
+    disconnect(m_ui->traceLoopCheckBox, SIGNAL(toggled(bool)),
+               this, SLOT(paramsChanged()));
 }
 
 Distribution DistributionParamsWidget::getDistributionParams()
@@ -82,7 +232,7 @@ Distribution DistributionParamsWidget::getDistributionParams()
     switch (m_ui->distributionComboBox->currentIndex())
     {
         case CONSTANT_PAGE_INDEX:
-            distributionParams.type = DistributionType::Uniform;
+            distributionParams.type = DistributionType::Constant;
             distributionParams.param1 = m_ui->constantValueSpinBox->value();
             break;
 
@@ -103,6 +253,67 @@ Distribution DistributionParamsWidget::getDistributionParams()
             distributionParams.param1 = m_ui->exponentialMeanSpinBox->value();
             break;
 
+        case LOGNORMAL_PAGE_INDEX:
+            distributionParams.type = DistributionType::Lognormal;
+            distributionParams.param1 = m_ui->lognormalMeanSpinBox->value();
+            distributionParams.param2 = m_ui->lognormalStdDevSpinBox->value();
+            break;
+
+        case GAMMA_PAGE_INDEX:
+            distributionParams.type = DistributionType::Gamma;
+            distributionParams.param1 = m_ui->gammaShapeSpinBox->value();
+            distributionParams.param2 = m_ui->gammaScaleSpinBox->value();
+            break;
+
+        case ERLANG_PAGE_INDEX:
+            distributionParams.type = DistributionType::Erlang;
+            distributionParams.param1 = m_ui->erlangPhaseCountSpinBox->value();
+            distributionParams.param2 = m_ui->erlangPhaseMeanSpinBox->value();
+            break;
+
+        case WEIBULL_PAGE_INDEX:
+            distributionParams.type = DistributionType::Weibull;
+            distributionParams.param1 = m_ui->weibullShapeSpinBox->value();
+            distributionParams.param2 = m_ui->weibullScaleSpinBox->value();
+            break;
+
+        case HYPER_EXPONENTIAL_PAGE_INDEX:
+            distributionParams.type = DistributionType::HyperExponential;
+            distributionParams.params = parseParamList(m_ui->hyperExponentialBranchesLineEdit->text());
+            break;
+
+        case PHASE_TYPE_PAGE_INDEX:
+            distributionParams.type = DistributionType::PhaseType;
+            setPhaseParams(distributionParams, m_ui->phaseTypeParamsLineEdit->text());
+            break;
+
+        case MARKOV_MODULATED_POISSON_PAGE_INDEX:
+            distributionParams.type = DistributionType::MarkovModulatedPoisson;
+            setPhaseParams(distributionParams, m_ui->markovModulatedPoissonParamsLineEdit->text());
+            break;
+
+        case MARKOVIAN_ARRIVAL_PAGE_INDEX:
+            distributionParams.type = DistributionType::MarkovianArrival;
+            setPhaseParams(distributionParams, m_ui->markovianArrivalParamsLineEdit->text());
+            break;
+
+        case NON_HOMOGENEOUS_POISSON_PAGE_INDEX:
+            distributionParams.type = DistributionType::NonHomogeneousPoisson;
+            distributionParams.param1 = m_ui->nonHomogeneousPoissonLinearCheckBox->isChecked() ? 1.0 : 0.0;
+            distributionParams.params = parseParamList(m_ui->nonHomogeneousPoissonScheduleLineEdit->text());
+            break;
+
+        case EMPIRICAL_PAGE_INDEX:
+            distributionParams.type = DistributionType::Empirical;
+            distributionParams.table = EmpiricalTable::load(m_ui->empiricalTableLineEdit->text());
+            break;
+
+        case TRACE_PAGE_INDEX:
+            distributionParams.type = DistributionType::Trace;
+            distributionParams.param1 = m_ui->traceLoopCheckBox->isChecked() ? 1.0 : 0.0;
+            distributionParams.trace = TraceFile::open(m_ui->traceFileLineEdit->text());
+            break;
+
         default:
             break;
     }
@@ -138,13 +349,174 @@ void DistributionParamsWidget::setDistributionParams(const Distribution& distrib
             m_ui->exponentialMeanSpinBox->setValue(distributionParams.param1);
             break;
 
+        case DistributionType::Lognormal:
+            m_ui->distributionComboBox->setCurrentIndex(LOGNORMAL_PAGE_INDEX);
+            m_ui->lognormalMeanSpinBox->setValue(distributionParams.param1);
+            m_ui->lognormalStdDevSpinBox->setValue(distributionParams.param2);
+            break;
+
+        case DistributionType::Gamma:
+            m_ui->distributionComboBox->setCurrentIndex(GAMMA_PAGE_INDEX);
+            m_ui->gammaShapeSpinBox->setValue(distributionParams.param1);
+            m_ui->gammaScaleSpinBox->setValue(distributionParams.param2);
+            break;
+
+        case DistributionType::Erlang:
+            m_ui->distributionComboBox->setCurrentIndex(ERLANG_PAGE_INDEX);
+            m_ui->erlangPhaseCountSpinBox->setValue(static_cast<int>(distributionParams.param1));
+            m_ui->erlangPhaseMeanSpinBox->setValue(distributionParams.param2);
+            break;
+
+        case DistributionType::Weibull:
+            m_ui->distributionComboBox->setCurrentIndex(WEIBULL_PAGE_INDEX);
+            m_ui->weibullShapeSpinBox->setValue(distributionParams.param1);
+            m_ui->weibullScaleSpinBox->setValue(distributionParams.param2);
+            break;
+
+        case DistributionType::HyperExponential:
+            m_ui->distributionComboBox->setCurrentIndex(HYPER_EXPONENTIAL_PAGE_INDEX);
+            m_ui->hyperExponentialBranchesLineEdit->setText(paramListToString(distributionParams.params));
+            break;
+
+        case DistributionType::PhaseType:
+            m_ui->distributionComboBox->setCurrentIndex(PHASE_TYPE_PAGE_INDEX);
+            m_ui->phaseTypeParamsLineEdit->setText(phaseParamsToString(distributionParams));
+            break;
+
+        case DistributionType::MarkovModulatedPoisson:
+            m_ui->distributionComboBox->setCurrentIndex(MARKOV_MODULATED_POISSON_PAGE_INDEX);
+            m_ui->markovModulatedPoissonParamsLineEdit->setText(phaseParamsToString(distributionParams));
+            break;
+
+        case DistributionType::MarkovianArrival:
+            m_ui->distributionComboBox->setCurrentIndex(MARKOVIAN_ARRIVAL_PAGE_INDEX);
+            m_ui->markovianArrivalParamsLineEdit->setText(phaseParamsToString(distributionParams));
+            break;
+
+        case DistributionType::NonHomogeneousPoisson:
+            m_ui->distributionComboBox->setCurrentIndex(NON_HOMOGENEOUS_POISSON_PAGE_INDEX);
+            m_ui->nonHomogeneousPoissonLinearCheckBox->setChecked(distributionParams.param1 != 0.0);
+            m_ui->nonHomogeneousPoissonScheduleLineEdit->setText(paramListToString(distributionParams.params));
+            break;
+
+        case DistributionType::Empirical:
+            m_ui->distributionComboBox->setCurrentIndex(EMPIRICAL_PAGE_INDEX);
+            m_ui->empiricalTableLineEdit->setText(distributionParams.table.isNull()
+                                                  ? QString() : distributionParams.table->getPath());
+            break;
+
+        case DistributionType::Trace:
+            m_ui->distributionComboBox->setCurrentIndex(TRACE_PAGE_INDEX);
+            m_ui->traceLoopCheckBox->setChecked(distributionParams.param1 != 0.0);
+            m_ui->traceFileLineEdit->setText(distributionParams.trace.isNull()
+                                             ? QString() : distributionParams.trace->getPath());
+            break;
+
         default:
             break;
     }
 
+    updateParamsTextStyle();
+
     connectControls();
 }
 
+// Parameters are only passed on once they are valid, which matters for the
+// ones typed as text
+void DistributionParamsWidget::paramsChanged()
+{
+    if (updateParamsTextStyle())
+    {
+        emit distributionParamsChanged();
+    }
+}
+
+void DistributionParamsWidget::browseEmpiricalTable()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+        this, tr("Open an empirical distribution table"), "", tr("Text files (*.txt *.csv)"));
+
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    m_ui->empiricalTableLineEdit->setText(fileName);
+    paramsChanged();
+}
+
+void DistributionParamsWidget::browseTraceFile()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+        this, tr("Open a trace"), "", tr("Trace files (*.trace);;All files (*)"));
+
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    m_ui->traceFileLineEdit->setText(fileName);
+    paramsChanged();
+}
+
+bool DistributionParamsWidget::updateParamsTextStyle()
+{
+    Distribution distributionParams = getDistributionParams();
+    bool valid = DistributionSampler::isValid(distributionParams);
+
+    QLineEdit* lineEdits[] =
+    {
+        m_ui->hyperExponentialBranchesLineEdit,
+        m_ui->phaseTypeParamsLineEdit,
+        m_ui->markovModulatedPoissonParamsLineEdit,
+        m_ui->markovianArrivalParamsLineEdit,
+        m_ui->nonHomogeneousPoissonScheduleLineEdit,
+        m_ui->empiricalTableLineEdit,
+        m_ui->traceFileLineEdit
+    };
+
+    for (QLineEdit* lineEdit : lineEdits)
+    {
+        lineEdit->setStyleSheet(QString());
+    }
+
+    switch (distributionParams.type)
+    {
+        case DistributionType::HyperExponential:
+            m_ui->hyperExponentialBranchesLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        case DistributionType::PhaseType:
+            m_ui->phaseTypeParamsLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        case DistributionType::MarkovModulatedPoisson:
+            m_ui->markovModulatedPoissonParamsLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        case DistributionType::MarkovianArrival:
+            m_ui->markovianArrivalParamsLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        case DistributionType::NonHomogeneousPoisson:
+            m_ui->nonHomogeneousPoissonScheduleLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        case DistributionType::Empirical:
+            m_ui->empiricalTableLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        case DistributionType::Trace:
+            m_ui->traceFileLineEdit->setStyleSheet(valid ? QString() : INVALID_PARAMS_STYLE);
+            break;
+
+        default:
+            break;
+    }
+
+    return valid;
+}
+
 void DistributionParamsWidget::setStackedWidgetIndex(int index)
 {
     if (m_ui->paramsStackedWidget->currentWidget() != nullptr)
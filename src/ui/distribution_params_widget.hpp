@@ -24,10 +24,14 @@ signals:
 
 private slots:
     void setStackedWidgetIndex(int index);
+    void paramsChanged();
+    void browseEmpiricalTable();
+    void browseTraceFile();
 
 private:
     void connectControls();
     void disconnectControls();
+    bool updateParamsTextStyle();
 
 private:
     Ui::DistributionParamsWidget* m_ui;
@@ -2,6 +2,9 @@
 
 #include "engine/simulation.hpp"
 
+#include "stats/sequential_stopping_rule.hpp"
+#include "stats/stat_factory.hpp"
+
 #include "ui/connection_item.hpp"
 #include "ui/simulation_scene.hpp"
 #include "ui/simulation_thread.hpp"
@@ -21,6 +24,7 @@ MainWindow::MainWindow()
  , m_simulation(nullptr)
  , m_simulationScene(nullptr)
  , m_simulationThread(nullptr)
+ , m_stoppingRule(nullptr)
  , m_statisticsWindow(nullptr)
  , m_updateInfoTimer(nullptr)
  , m_simulationStateLabel(nullptr)
@@ -53,6 +57,14 @@ MainWindow::MainWindow()
     m_nextEventTimeLabel = new QLabel(this);
     m_ui->statusBar->addWidget(m_nextEventTimeLabel, 1);
 
+    for (StatType type : StatFactory::getTypes())
+    {
+        if (!StatFactory::isStationStat(type))
+        {
+            m_ui->precisionStatComboBox->addItem(StatFactory::getName(type), static_cast<int>(type));
+        }
+    }
+
     setSampleSimulationInstance();
 
     updateStationParams();
@@ -77,6 +89,18 @@ MainWindow::MainWindow()
     connect(m_updateInfoTimer, SIGNAL(timeout()),
             this, SLOT(updateSimulationInfo()));
 
+    connect(m_ui->precisionStatComboBox, SIGNAL(currentIndexChanged(int)),
+            this, SLOT(stoppingRuleChanged()));
+
+    connect(m_ui->precisionSpinBox, SIGNAL(valueChanged(double)),
+            this, SLOT(stoppingRuleChanged()));
+
+    connect(m_simulationThread, SIGNAL(stoppingRuleSatisfied(double, double)),
+            this, SLOT(stoppingRuleSatisfied(double, double)));
+
+    connect(m_simulationThread, SIGNAL(simulationStopped()),
+            this, SLOT(simulationStopped()));
+
     connect(m_ui->arrivalDistributionParamsWidget, SIGNAL(distributionParamsChanged()),
             this, SLOT(arrivalDistributionParamsChanged()));
 
@@ -127,12 +151,15 @@ MainWindow::~MainWindow()
     delete m_nextEventTimeLabel;
     m_nextEventTimeLabel = nullptr;
 
-    delete m_simulation;
-    m_simulation = nullptr;
-
     delete m_simulationThread;
     m_simulationThread = nullptr;
 
+    delete m_stoppingRule;
+    m_stoppingRule = nullptr;
+
+    delete m_simulation;
+    m_simulation = nullptr;
+
     delete m_updateInfoTimer;
     m_updateInfoTimer = nullptr;
 
@@ -517,6 +544,38 @@ void MainWindow::updateSimulationInfo()
     m_nextEventTimeLabel->setText(QString("Time of next event: %1 s").arg(info.nextEventTime, 0, 'f', 3));
 }
 
+void MainWindow::stoppingRuleChanged()
+{
+    SequentialStoppingRule* oldStoppingRule = m_stoppingRule;
+    m_stoppingRule = nullptr;
+
+    double precision = m_ui->precisionSpinBox->value() / 100.0;
+    if (precision > 0.0)
+    {
+        StatType type = static_cast<StatType>(m_ui->precisionStatComboBox->currentData().toInt());
+        m_stoppingRule = new SequentialStoppingRule(type, INVALID_STATION_ID, precision);
+    }
+
+    m_simulationThread->setStoppingRule(m_stoppingRule);
+    delete oldStoppingRule;
+}
+
+void MainWindow::stoppingRuleSatisfied(double mean, double halfWidth)
+{
+    simulationStopped();
+
+    QMessageBox::information(this, tr("Queues"),
+                             tr("Requested precision reached: %1 +- %2")
+                             .arg(mean, 0, 'f', 4).arg(halfWidth, 0, 'f', 4));
+}
+
+void MainWindow::simulationStopped()
+{
+    m_ui->singleStepButton->setEnabled(true);
+    m_ui->startStopButton->setText("Start");
+    m_ui->simulationView->setInteractive(true);
+}
+
 void MainWindow::newEvent(Event event)
 {
     m_simulationScene->newEvent(event);
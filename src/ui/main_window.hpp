@@ -9,6 +9,7 @@ namespace Ui
     class MainWindow;
 }
 
+class SequentialStoppingRule;
 class Simulation;
 class SimulationScene;
 class SimulationThread;
@@ -55,6 +56,10 @@ private slots:
     void newEvent(Event event);
     void updateSimulationInfo();
 
+    void stoppingRuleChanged();
+    void stoppingRuleSatisfied(double mean, double halfWidth);
+    void simulationStopped();
+
 private:
     void connectStationParamsWidgets();
     void disconnectStationParamsWidgets();
@@ -69,6 +74,7 @@ private:
     Simulation* m_simulation;
     SimulationScene* m_simulationScene;
     SimulationThread* m_simulationThread;
+    SequentialStoppingRule* m_stoppingRule;
     StatisticsWindow* m_statisticsWindow;
     QTimer* m_updateInfoTimer;
     QLabel* m_simulationStateLabel;
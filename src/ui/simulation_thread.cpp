@@ -1,6 +1,7 @@
 #include "ui/simulation_thread.hpp"
 
 #include "engine/simulation.hpp"
+#include "stats/sequential_stopping_rule.hpp"
 
 #include <QElapsedTimer>
 
@@ -8,11 +9,20 @@
 SimulationThread::SimulationThread(QObject* parent, Simulation* simulation)
  : QThread(parent)
  , m_simulation(simulation)
+ , m_stoppingRule(nullptr)
+ , m_stoppingRuleActive(false)
  , m_speed(1.0)
  , m_state(State::Idle)
  , m_speedChanged(false)
  , m_end(false)
 {
+    m_simulation->addEventListener(this);
+}
+
+SimulationThread::~SimulationThread()
+{
+    m_simulation->removeEventListener(this);
+    setStoppingRuleActive(false);
 }
 
 void SimulationThread::startSimulation()
@@ -36,6 +46,11 @@ void SimulationThread::resetSimulation()
     m_mutex.lock();
     m_state = State::Idle;
     m_simulation->reset();
+    if (m_stoppingRule != nullptr)
+    {
+        m_stoppingRule->reset();
+        setStoppingRuleActive(true);
+    }
     m_waitCondition.wakeOne();
     m_mutex.unlock();
 }
@@ -65,6 +80,18 @@ void SimulationThread::endThread()
     m_mutex.unlock();
 }
 
+void SimulationThread::setStoppingRule(SequentialStoppingRule* stoppingRule)
+{
+    m_mutex.lock();
+    setStoppingRuleActive(false);
+    m_stoppingRule = stoppingRule;
+    if (m_simulation->getProcessedEventCount() == 0)
+    {
+        setStoppingRuleActive(true);
+    }
+    m_mutex.unlock();
+}
+
 SimulationThread::SimulationInfo SimulationThread::getSimulationInfo()
 {
     SimulationInfo info;
@@ -100,12 +127,28 @@ void SimulationThread::run()
     {
         unsigned long waitTime = ULONG_MAX;
 
+        // Traces may run out, leaving nothing more to simulate
+        if (!m_simulation->hasPendingEvents() || m_simulation->isTraceEnded())
+        {
+            if (m_state == State::Running)
+            {
+                emit simulationStopped();
+            }
+            m_state = State::Idle;
+        }
+
         if (!m_speedChanged && (m_state == State::Running || m_state == State::SingleStep))
         {
-            Event event = m_simulation->simulateNextStep();
+            m_simulation->simulateNextStep();
             m_simulation->debugDump();
-            emit newEvent(event);
             m_elapsedTimer.start();
+
+            if (m_state == State::Running && m_stoppingRuleActive && m_stoppingRule->isSatisfied())
+            {
+                m_state = State::Idle;
+                setStoppingRuleActive(false);
+                emit stoppingRuleSatisfied(m_stoppingRule->getMean(), m_stoppingRule->getHalfWidth());
+            }
         }
 
         if (m_speedChanged || m_state == State::Running)
@@ -125,3 +168,29 @@ void SimulationThread::run()
 
     m_mutex.unlock();
 }
+
+// The rule's stat has to see the run from its start, so a rule is only
+// observing from a reset on, and once satisfied it no longer stops a run
+// which is started again
+void SimulationThread::setStoppingRuleActive(bool active)
+{
+    if (m_stoppingRule == nullptr || active == m_stoppingRuleActive)
+    {
+        return;
+    }
+
+    if (active)
+    {
+        m_simulation->addEventListener(m_stoppingRule);
+    }
+    else
+    {
+        m_simulation->removeEventListener(m_stoppingRule);
+    }
+    m_stoppingRuleActive = active;
+}
+
+void SimulationThread::eventProcessed(const Event& event)
+{
+    emit newEvent(event);
+}
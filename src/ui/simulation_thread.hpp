@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/event.hpp"
+#include "engine/event_listener.hpp"
 
 #include <QElapsedTimer>
 #include <QMutex>
@@ -8,8 +9,9 @@
 #include <QWaitCondition>
 
 class Simulation;
+class SequentialStoppingRule;
 
-class SimulationThread : public QThread
+class SimulationThread : public QThread, public EventListener
 {
     Q_OBJECT
 public:
@@ -30,12 +32,18 @@ public:
 
 public:
     explicit SimulationThread(QObject* parent, Simulation* simulation);
+    virtual ~SimulationThread();
 
     void stopSimulation();
     void startSimulation();
     void resetSimulation();
     void endThread();
 
+    // Stops a running simulation once the rule is satisfied; the rule is not
+    // owned, null disables it. A rule set after the simulation has started
+    // takes effect from the next reset.
+    void setStoppingRule(SequentialStoppingRule* stoppingRule);
+
     SimulationInfo getSimulationInfo();
     State getState();
 
@@ -45,12 +53,20 @@ public slots:
 
 protected:
     virtual void run() override;
+    virtual void eventProcessed(const Event& event) override;
 
 signals:
     void newEvent(Event event);
+    void stoppingRuleSatisfied(double mean, double halfWidth);
+    void simulationStopped();
+
+private:
+    void setStoppingRuleActive(bool active);
 
 private:
     Simulation* m_simulation;
+    SequentialStoppingRule* m_stoppingRule;
+    bool m_stoppingRuleActive;
     double m_speed;
     State m_state;
     bool m_speedChanged;
@@ -1,5 +1,7 @@
 #include "ui/statistic_item_widget.hpp"
 
+#include "stats/stat_factory.hpp"
+
 #include "ui_statistic_item_widget.h"
 
 
@@ -12,16 +14,10 @@ StatisticItemWidget::StatisticItemWidget(QWidget* parent, int index)
 
     setIndex(index);
 
-    m_ui->typeComboBox->addItem(QString::fromUtf8("T_t syst."),
-                                static_cast<int>(StatType::SystemMeanTaskProcessingTime));
-    m_ui->typeComboBox->addItem(QString::fromUtf8("N_t syst."),
-                                static_cast<int>(StatType::SystemMeanNumberOfTasks));
-    m_ui->typeComboBox->addItem(QString::fromUtf8("U_p stat."),
-                                static_cast<int>(StatType::StationMeanUtilizedProcessors));
-    m_ui->typeComboBox->addItem(QString::fromUtf8("T_q stat."),
-                                static_cast<int>(StatType::StationMeanWaitTime));
-    m_ui->typeComboBox->addItem(QString::fromUtf8("N_q stat."),
-                                static_cast<int>(StatType::StationMeanQueueLength));
+    for (StatType type : StatFactory::getTypes())
+    {
+        m_ui->typeComboBox->addItem(StatFactory::getName(type), static_cast<int>(type));
+    }
 
     m_ui->stationLineEdit->setValidator(new QIntValidator(1, 100));
 
@@ -69,17 +65,9 @@ int StatisticItemWidget::getStationId() const
 void StatisticItemWidget::adjustOnTypeChanged()
 {
     StatType statType = getType();
-    if (statType == StatType::SystemMeanNumberOfTasks ||
-        statType == StatType::SystemMeanTaskProcessingTime)
-    {
-        m_ui->stationLabel->setVisible(false);
-        m_ui->stationLineEdit->setVisible(false);
-    }
-    else
-    {
-        m_ui->stationLabel->setVisible(true);
-        m_ui->stationLineEdit->setVisible(true);
-    }
+    bool isStationStat = StatFactory::isStationStat(statType);
+    m_ui->stationLabel->setVisible(isStationStat);
+    m_ui->stationLineEdit->setVisible(isStationStat);
 }
 
 void StatisticItemWidget::typeChanged()
@@ -1,6 +1,6 @@
 #include "ui/statistics_window.hpp"
 
-#include "stats/station_stats.hpp"
+#include "stats/stat_factory.hpp"
 #include "stats/system_stats.hpp"
 
 #include "ui/statistics_series_data.hpp"
@@ -108,29 +108,7 @@ void StatisticsWindow::statisticTypeChanged(int index)
     StatType statType = data.widget->getType();
     int stationId = data.widget->getStationId();
 
-    Stat* newStat = nullptr;
-    switch (statType)
-    {
-        case StatType::SystemMeanTaskProcessingTime:
-            newStat = new SystemMeanTaskProcessingTimeStat();
-            break;
-
-        case StatType::SystemMeanNumberOfTasks:
-            newStat = new SystemMeanNumberOfTasksStat();
-            break;
-
-        case StatType::StationMeanUtilizedProcessors:
-            newStat = new StationMeanUtilizedProcessorsStat(stationId);
-            break;
-
-        case StatType::StationMeanQueueLength:
-            newStat = new StationMeanQueueLengthStat(stationId);
-            break;
-
-        case StatType::StationMeanWaitTime:
-            newStat = new StationMeanWaitTimeStat(stationId);
-            break;
-    }
+    Stat* newStat = StatFactory::createStat(statType, stationId);
 
     data.curve->setData(nullptr);
     data.seriesData = new StatisticsSeriesData(newStat);
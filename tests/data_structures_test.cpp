@@ -0,0 +1,253 @@
+#include "test_report.hpp"
+
+#include "engine/random_stream.hpp"
+#include "engine/task_queue.hpp"
+#include "engine/weighted_selector.hpp"
+#include "stats/steady_state_stat.hpp"
+#include "stats/welford_accumulator.hpp"
+
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+
+// Checks the engine and statistics data structures against straightforward
+// reference implementations
+namespace
+{
+    bool isClose(double a, double b)
+    {
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+    }
+
+    int findLinear(const QVector<int>& weights, int value)
+    {
+        for (int i = 0; i < weights.size(); ++i)
+        {
+            if (value < weights.at(i))
+            {
+                return i;
+            }
+            value -= weights.at(i);
+        }
+        return -1;
+    }
+
+    bool findsAllValues(const WeightedSelector& selector, const QVector<int>& weights)
+    {
+        int totalWeight = 0;
+        for (int weight : weights)
+        {
+            totalWeight += weight;
+        }
+
+        if (selector.getTotalWeight() != totalWeight)
+        {
+            return false;
+        }
+
+        for (int value = 0; value < totalWeight; ++value)
+        {
+            if (selector.find(value) != findLinear(weights, value))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void checkWeightedSelector(TestReport& report)
+    {
+        RandomStream random;
+        random.seed(DEFAULT_RANDOM_SEED, 0, RandomStreamType::Routing, 1);
+
+        bool found = true;
+        bool foundAfterChange = true;
+
+        for (int size = 1; size <= 33; ++size)
+        {
+            QVector<int> weights(size);
+            for (int i = 0; i < size; ++i)
+            {
+                weights[i] = random.next64() % 4;
+            }
+
+            WeightedSelector selector;
+            selector.reset(weights);
+            found = found && findsAllValues(selector, weights);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                int index = random.next64() % size;
+                weights[index] = random.next64() % 5;
+                selector.setWeight(index, weights.at(index));
+                foundAfterChange = foundAfterChange && findsAllValues(selector, weights);
+            }
+        }
+
+        report.check(found, "weighted selector finds the same item as a linear scan");
+        report.check(foundAfterChange, "weighted selector finds the same item as a linear scan after weight changes");
+    }
+
+    // Random pushes, pops and removals, so the ring buffer wraps around and,
+    // when unbounded, grows while wrapped
+    bool matchesList(int capacity, RandomStream& random)
+    {
+        TaskQueue queue;
+        queue.reset(capacity);
+        QList<int> tasks;
+        int nextTaskId = 1;
+
+        for (int i = 0; i < 5000; ++i)
+        {
+            int operation = random.next64() % 8;
+            if (operation < 4 && !queue.isFull())
+            {
+                queue.push(nextTaskId);
+                tasks.append(nextTaskId);
+                ++nextTaskId;
+            }
+            else if (operation < 7 && !queue.isEmpty())
+            {
+                if (queue.popFront() != tasks.takeFirst())
+                {
+                    return false;
+                }
+            }
+            else if (!queue.isEmpty())
+            {
+                int taskId = tasks.at(random.next64() % tasks.size());
+                tasks.removeOne(taskId);
+                if (!queue.remove(taskId))
+                {
+                    return false;
+                }
+            }
+
+            if (queue.size() != tasks.size() || queue.toList() != tasks)
+            {
+                return false;
+            }
+
+            if (capacity > 0 && queue.isFull() != (tasks.size() == capacity))
+            {
+                return false;
+            }
+        }
+
+        return !queue.remove(nextTaskId);
+    }
+
+    void checkTaskQueue(TestReport& report)
+    {
+        RandomStream random;
+        random.seed(DEFAULT_RANDOM_SEED, 0, RandomStreamType::QueueSelection, 1);
+
+        report.check(matchesList(1, random), "task queue of capacity 1 keeps FIFO order");
+        report.check(matchesList(5, random), "bounded task queue keeps FIFO order when wrapping around");
+        report.check(matchesList(0, random), "unbounded task queue keeps FIFO order when growing");
+
+        TaskQueue queue;
+        queue.reset(4);
+        for (int taskId = 1; taskId <= 4; ++taskId)
+        {
+            queue.push(taskId);
+        }
+        queue.popFront();
+        queue.popFront();
+        queue.push(5);
+        queue.push(6);
+        queue.moveToFront(2);
+        report.check(queue.popFront() == 5 && queue.toList() == (QList<int>() << 4 << 3 << 6),
+                     "task queue moves a wrapped task to the front");
+    }
+
+    void checkWelfordMerge(TestReport& report)
+    {
+        RandomStream random;
+        random.seed(DEFAULT_RANDOM_SEED, 0, RandomStreamType::Service, 1);
+
+        const int sizes[] = {0, 1, 17, 1000, 2};
+
+        WelfordAccumulator sequential;
+        WelfordAccumulator merged;
+
+        for (int size : sizes)
+        {
+            WelfordAccumulator part;
+            for (int i = 0; i < size; ++i)
+            {
+                double value = 100.0 + 10.0 * random.nextDouble();
+                sequential.add(value);
+                part.add(value);
+            }
+            merged.merge(part);
+        }
+
+        report.check(merged.getCount() == sequential.getCount(), "merged accumulator has the same count");
+        report.check(isClose(merged.getMean(), sequential.getMean()), "merged accumulator has the same mean");
+        report.check(isClose(merged.getVariance(), sequential.getVariance()),
+                     "merged accumulator has the same variance");
+
+        WelfordAccumulator empty;
+        empty.merge(WelfordAccumulator());
+        report.check(empty.getCount() == 0 && empty.getMean() == 0.0, "merging empty accumulators stays empty");
+    }
+
+    // Adds the value carried in the task id of every event, one per time unit
+    class SeriesStat : public Stat
+    {
+    public:
+        virtual bool update(Event event) override
+        {
+            m_sum += event.taskId;
+            m_weight += 1.0;
+            updateValue();
+            return true;
+        }
+
+        virtual void reset() override
+        {
+            resetValue();
+        }
+    };
+
+    // A transient of 50 observations at 10 followed by a steady series
+    // alternating between 1 and 2, so MSER-5 must cut exactly 10 batches
+    void checkSteadyStateTruncation(TestReport& report)
+    {
+        const int warmUpCount = 50;
+        const int steadyCount = 500;
+
+        SteadyStateStat stat(new SeriesStat(), 1.0);
+        for (int i = 0; i < warmUpCount + steadyCount; ++i)
+        {
+            int value = i < warmUpCount ? 10 : 1 + i % 2;
+            stat.update(Event(EventType::TaskOutput, i + 1.0, OUTPUT_STATION_ID, value));
+        }
+
+        report.check(stat.getObservationCount() == warmUpCount + steadyCount,
+                     "steady-state stat takes one observation per interval");
+        report.check(stat.getWarmUpObservationCount() == warmUpCount, "MSER-5 cuts off the transient");
+        report.check(stat.getWarmUpTime() == warmUpCount, "warm-up ends at the end of the transient");
+        report.check(isClose(stat.getValue(), 1.5), "steady-state mean excludes the transient");
+        report.check(stat.getBatchCount() == SteadyStateStat::DEFAULT_BATCH_COUNT,
+                     "steady-state stat splits the rest into batches");
+    }
+}
+
+
+int main()
+{
+    TestReport report;
+
+    checkWeightedSelector(report);
+    checkTaskQueue(report);
+    checkWelfordMerge(report);
+    checkSteadyStateTruncation(report);
+
+    return report.getExitCode();
+}
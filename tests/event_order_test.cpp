@@ -0,0 +1,218 @@
+#include "test_report.hpp"
+
+#include "engine/event_listener.hpp"
+#include "engine/event_priority_queue.hpp"
+#include "engine/random_stream.hpp"
+#include "engine/simulation.hpp"
+
+#include <QVector>
+
+#include <memory>
+
+
+// Checks that all future event set backends give the same event order for
+// the same seed, both on their own and driving a simulation
+namespace
+{
+    const int SIMULATED_EVENT_COUNT = 50000;
+    const int QUEUE_OPERATION_COUNT = 20000;
+    const double TICKS_PER_TIME_UNIT = 1000.0;
+
+    class EventRecorder : public EventListener
+    {
+    public:
+        virtual void eventProcessed(const Event& event) override
+        {
+            if (events.size() < SIMULATED_EVENT_COUNT)
+            {
+                events.append(event);
+            }
+        }
+
+    public:
+        QVector<Event> events;
+    };
+
+    bool isSameEvent(const Event& a, const Event& b)
+    {
+        return a.type == b.type && a.time == b.time && a.stationId == b.stationId && a.taskId == b.taskId;
+    }
+
+    bool isSameOrder(const QVector<Event>& a, const QVector<Event>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (int i = 0; i < a.size(); ++i)
+        {
+            if (!isSameEvent(a.at(i), b.at(i)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Two routes of different length, a random order queue and blocking
+    // behind short queues, so that many events are scheduled at equal times
+    SimulationInstance createInstance()
+    {
+        SimulationInstance instance;
+        instance.arrivalTimeDistribution.type = DistributionType::Exponential;
+        instance.arrivalTimeDistribution.param1 = 1.0;
+
+        Station input;
+        input.id = INPUT_STATION_ID;
+        instance.stations.append(input);
+
+        Station output;
+        output.id = OUTPUT_STATION_ID;
+        instance.stations.append(output);
+
+        const int processorCounts[] = {2, 1, 1, 3};
+        const QueueType queueTypes[] = {QueueType::Fifo, QueueType::Random, QueueType::Fifo, QueueType::Fifo};
+        const int queueLengths[] = {3, 0, 2, 1};
+        const double serviceTimes[] = {1.5, 1.2, 1.9, 2.5};
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Station station;
+            station.id = i + 1;
+            station.processorCount = processorCounts[i];
+            station.queueType = queueTypes[i];
+            station.queueLength = queueLengths[i];
+            station.serviceTimeDistribution.type = DistributionType::Exponential;
+            station.serviceTimeDistribution.param1 = serviceTimes[i];
+            instance.stations.append(station);
+        }
+
+        const int connections[][3] = {
+            {INPUT_STATION_ID, 1, 1},
+            {1, 2, 2},
+            {1, 3, 1},
+            {2, 4, 1},
+            {3, 4, 1},
+            {3, OUTPUT_STATION_ID, 1},
+            {4, OUTPUT_STATION_ID, 1}
+        };
+
+        for (const auto& params : connections)
+        {
+            Connection connection;
+            connection.from = params[0];
+            connection.to = params[1];
+            connection.weight = params[2];
+            instance.connections.append(connection);
+        }
+
+        return instance;
+    }
+
+    QVector<Event> simulate(EventQueueType type, double ticksPerTimeUnit, bool fused)
+    {
+        Simulation simulation;
+        EventRecorder recorder;
+        simulation.addEventListener(&recorder);
+
+        simulation.setRandomSeed(20240611);
+        simulation.setTickResolution(ticksPerTimeUnit);
+        simulation.setEventQueueType(type);
+        simulation.setFusedTransitions(fused);
+        simulation.setInstance(createInstance());
+
+        while (recorder.events.size() < SIMULATED_EVENT_COUNT)
+        {
+            simulation.simulateNextStep();
+        }
+
+        return recorder.events;
+    }
+
+    // Drives the queues directly with events on a 1/8 time grid, which is
+    // exact both in floating point and in ticks, so every key has many ties
+    void checkQueueOrder(TestReport& report)
+    {
+        TickResolution resolution(TICKS_PER_TIME_UNIT);
+        std::unique_ptr<EventPriorityQueue> heap(EventPriorityQueue::create(EventQueueType::Heap, resolution));
+        std::unique_ptr<EventPriorityQueue> calendar(EventPriorityQueue::create(EventQueueType::Calendar, resolution));
+        std::unique_ptr<EventPriorityQueue> radixHeap(EventPriorityQueue::create(EventQueueType::RadixHeap, resolution));
+        EventPriorityQueue* queues[] = {heap.get(), calendar.get(), radixHeap.get()};
+
+        RandomStream random;
+        random.seed(DEFAULT_RANDOM_SEED, 0, RandomStreamType::Arrival, INPUT_STATION_ID);
+
+        int nextTaskId = 1;
+        int size = 0;
+        auto enqueue = [&](double time)
+        {
+            Event event(EventType::TaskEndedProcessing, time, 1, nextTaskId++);
+            for (EventPriorityQueue* queue : queues)
+            {
+                queue->enqueue(event);
+            }
+            ++size;
+        };
+
+        for (int i = 0; i < 100; ++i)
+        {
+            enqueue((random.next64() % 64) / 8.0);
+        }
+
+        bool sameOrder = true;
+        bool sameDue = true;
+        double time = 0.0;
+
+        for (int i = 0; i < QUEUE_OPERATION_COUNT; ++i)
+        {
+            bool due = heap->hasEventDue(time);
+            sameDue = sameDue && calendar->hasEventDue(time) == due && radixHeap->hasEventDue(time) == due;
+
+            Event event = heap->dequeue();
+            sameOrder = sameOrder && isSameEvent(calendar->dequeue(), event) && isSameEvent(radixHeap->dequeue(), event);
+            time = event.time;
+            --size;
+
+            int newEventCount = size < 100 ? 2 : random.next64() % 3;
+            for (int j = 0; j < newEventCount; ++j)
+            {
+                enqueue(time + (random.next64() % 16) / 8.0);
+            }
+        }
+
+        report.check(sameOrder, "heap, calendar and radix heap dequeue events in the same order");
+        report.check(sameDue, "heap, calendar and radix heap agree on due events");
+        report.check(calendar->isEmpty() == heap->isEmpty() && radixHeap->isEmpty() == heap->isEmpty(),
+                     "heap, calendar and radix heap hold the same number of events");
+    }
+
+    void checkSimulationOrder(TestReport& report)
+    {
+        QVector<Event> heap = simulate(EventQueueType::Heap, 0.0, false);
+        report.check(isSameOrder(simulate(EventQueueType::Calendar, 0.0, false), heap),
+                     "calendar gives the heap event order in continuous time");
+        report.check(isSameOrder(simulate(EventQueueType::Heap, 0.0, true), heap),
+                     "fused transitions give the same event order");
+
+        QVector<Event> heapTicks = simulate(EventQueueType::Heap, TICKS_PER_TIME_UNIT, false);
+        report.check(isSameOrder(simulate(EventQueueType::Calendar, TICKS_PER_TIME_UNIT, false), heapTicks),
+                     "calendar gives the heap event order in tick time");
+        report.check(isSameOrder(simulate(EventQueueType::RadixHeap, TICKS_PER_TIME_UNIT, false), heapTicks),
+                     "radix heap gives the heap event order in tick time");
+        report.check(isSameOrder(simulate(EventQueueType::RadixHeap, TICKS_PER_TIME_UNIT, true), heapTicks),
+                     "radix heap with fused transitions gives the heap event order in tick time");
+    }
+}
+
+
+int main()
+{
+    TestReport report;
+
+    checkQueueOrder(report);
+    checkSimulationOrder(report);
+
+    return report.getExitCode();
+}
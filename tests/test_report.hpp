@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+#include <QTextStream>
+
+#include <cstdio>
+
+
+// Collects the results of checks in a test executable, which exits with a
+// non-zero code when any of them failed
+class TestReport
+{
+public:
+    TestReport()
+     : m_err(stderr)
+     , m_failureCount(0)
+    {}
+
+    void check(bool condition, const QString& description)
+    {
+        if (!condition)
+        {
+            m_err << "FAILED: " << description << "\n";
+            m_err.flush();
+            ++m_failureCount;
+        }
+    }
+
+    int getExitCode() const
+    {
+        return m_failureCount == 0 ? 0 : 1;
+    }
+
+private:
+    QTextStream m_err;
+    int m_failureCount;
+};